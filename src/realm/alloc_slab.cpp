@@ -204,6 +204,7 @@ MemRef SlabAlloc::do_alloc(size_t size)
 
     m_free_space_state = free_space_Dirty;
     m_commit_size += size;
+    ++m_num_allocations;
 
     // minimal allocation is sizeof(FreeListEntry)
     if (size < sizeof(FreeBlock))
@@ -377,6 +378,43 @@ SlabAlloc::FreeBlock* SlabAlloc::allocate_block(int size)
     return block;
 }
 
+bool SlabAlloc::extend_block(ref_type ref, FreeBlock* block, int new_size)
+{
+    // The block is in use, so only its BetweenBlocks may be touched
+    auto bb = bb_before(block);
+    REALM_ASSERT_EX(bb->block_after_size < 0, bb->block_after_size, get_file_path_for_assertions());
+    int size = -bb->block_after_size;
+    if (size >= new_size)
+        return true;
+    auto bb_next = reinterpret_cast<BetweenBlocks*>(reinterpret_cast<char*>(block) + size);
+    FreeBlock* next = block_after(bb_next);
+    if (!next)
+        return false; // end of slab, or next block is in use
+    int combined_size = size + bb_next->block_after_size + int(sizeof(BetweenBlocks));
+    if (combined_size < new_size)
+        return false;
+    remove_freelist_entry(next);
+    auto bb_end = reinterpret_cast<BetweenBlocks*>(reinterpret_cast<char*>(block) + combined_size);
+    int remaining_size = combined_size - (new_size + int(sizeof(BetweenBlocks)));
+    if (remaining_size < static_cast<int>(sizeof(FreeBlock))) {
+        // take it all
+        bb->block_after_size = -combined_size;
+        bb_end->block_before_size = -combined_size;
+        return true;
+    }
+    // give back what is not needed
+    bb->block_after_size = -new_size;
+    auto bb_between = reinterpret_cast<BetweenBlocks*>(reinterpret_cast<char*>(block) + new_size);
+    bb_between->block_before_size = -new_size;
+    bb_between->block_after_size = remaining_size;
+    bb_end->block_before_size = remaining_size;
+    FreeBlock* remaining_block = block_after(bb_between);
+    remaining_block->ref = ref + new_size + sizeof(BetweenBlocks);
+    remaining_block->clear_links();
+    push_freelist_entry(remaining_block);
+    return true;
+}
+
 SlabAlloc::FreeBlock* SlabAlloc::slab_to_entry(const Slab& slab, ref_type ref_start)
 {
     auto bb = reinterpret_cast<BetweenBlocks*>(slab.addr);
@@ -603,9 +641,27 @@ MemRef SlabAlloc::do_realloc(size_t ref, char* addr, size_t old_size, size_t new
     REALM_ASSERT_EX(0 < new_size, new_size, get_file_path_for_assertions());
     REALM_ASSERT_EX((new_size & 0x7) == 0, new_size, get_file_path_for_assertions()); // only allow sizes that are multiples of 8
 
-    // FIXME: Check if we can extend current space. In that case, remember to
-    // check whether m_free_space_state == free_state_Invalid. Also remember to
-    // fill with zero if REALM_ENABLE_ALLOC_SET_ZERO is non-zero.
+    // Arrays grown repeatedly in a write transaction are often followed by
+    // free space, so try to extend the current space first. This saves the
+    // copying, and the caller from updating the parents with a new ref.
+    if (!is_read_only(ref)) {
+        CriticalSection cs(changes);
+        if (REALM_COVER_NEVER(m_free_space_state == free_space_Invalid))
+            throw InvalidFreeSpace();
+        if (extend_block(ref, reinterpret_cast<FreeBlock*>(addr), static_cast<int>(new_size))) {
+            m_commit_size += new_size - old_size;
+#if REALM_ENABLE_ALLOC_SET_ZERO
+            std::fill(addr + old_size, addr + new_size, 0);
+#endif
+#ifdef REALM_DEBUG
+            if (REALM_COVER_NEVER(m_debug_out)) {
+                std::cerr << "Realloc in place ref: " << ref << " old_size: " << old_size
+                          << " new_size: " << new_size << "\n";
+            }
+#endif // REALM_DEBUG
+            return MemRef(addr, ref, *this);
+        }
+    }
 
     // Allocate new space
     MemRef new_mem = do_alloc(new_size); // Throws
@@ -717,6 +773,8 @@ ref_type SlabAlloc::attach_file(const std::string& file_path, Config& cfg)
     // the call below to set_encryption_key.
     m_file.set_encryption_key(cfg.encryption_key);
     File::CloseGuard fcg(m_file);
+    if (cfg.access_hint != File::hint_Normal)
+        m_file.advise(cfg.access_hint);
 
     size_t size = 0;
     // The size of a database file must not exceed what can be encoded in
@@ -761,20 +819,40 @@ ref_type SlabAlloc::attach_file(const std::string& file_path, Config& cfg)
     try {
         note_reader_start(this);
         // we'll read header and (potentially) footer
-        File::Map<char> map_header(m_file, File::access_ReadOnly, sizeof(Header));
         // if file is too small we'll catch it in validate_header - but we need to prevent an invalid mapping first
         size_t footer_ref = size < (sizeof(StreamingFooter) + sizeof(Header)) ? 0 : (size - sizeof(StreamingFooter));
-        size_t footer_page_base = footer_ref & ~(page_size() - 1);
-        size_t footer_offset = footer_ref - footer_page_base;
-        File::Map<char> map_footer(m_file, footer_page_base, File::access_ReadOnly,
-                                   sizeof(StreamingFooter) + footer_offset, 0);
-        realm::util::encryption_read_barrier(map_header, 0, sizeof(Header));
-        realm::util::encryption_read_barrier(map_footer, footer_offset, sizeof(StreamingFooter));
-        auto header = reinterpret_cast<const Header*>(map_header.get_addr());
-        auto footer = reinterpret_cast<const StreamingFooter*>(map_footer.get_addr() + footer_offset);
+        File::Map<char> map_header;
+        File::Map<char> map_footer;
+        Header header_buf{};
+        StreamingFooter footer_buf{};
+        const Header* header = &header_buf;
+        const StreamingFooter* footer = &footer_buf;
+        if (cfg.encryption_key) {
+            // Encrypted files must be read through a mapping, which decrypts them
+            size_t footer_page_base = footer_ref & ~(page_size() - 1);
+            size_t footer_offset = footer_ref - footer_page_base;
+            map_header.map(m_file, File::access_ReadOnly, sizeof(Header));
+            map_footer.map(m_file, File::access_ReadOnly, sizeof(StreamingFooter) + footer_offset, 0,
+                           footer_page_base);
+            realm::util::encryption_read_barrier(map_header, 0, sizeof(Header));
+            realm::util::encryption_read_barrier(map_footer, footer_offset, sizeof(StreamingFooter));
+            header = reinterpret_cast<const Header*>(map_header.get_addr());
+            footer = reinterpret_cast<const StreamingFooter*>(map_footer.get_addr() + footer_offset);
+        }
+        else {
+            // Reading the few bytes is much cheaper than setting up (and
+            // faulting in) two mappings, which are torn down again right
+            // after. This matters for short-lived processes opening a file
+            // just to read from it.
+            m_file.seek(0);
+            m_file.read(reinterpret_cast<char*>(&header_buf), sizeof(Header));
+            m_file.seek(footer_ref);
+            m_file.read(reinterpret_cast<char*>(&footer_buf), sizeof(StreamingFooter));
+            m_file.seek(0);
+        }
         top_ref = validate_header(header, footer, size, path); // Throws
         m_attach_mode = cfg.is_shared ? attach_SharedFile : attach_UnsharedFile;
-        m_data = map_header.get_addr(); // <-- needed below
+        m_data = reinterpret_cast<const char*>(header); // <-- needed below
 
         // Make sure the database is not on streaming format. If we did not do this,
         // a later commit would have to do it. That would require coordination with
@@ -1048,6 +1126,7 @@ void SlabAlloc::reset_free_space_tracking()
     rebuild_freelists_from_slab();
     m_free_space_state = free_space_Clean;
     m_commit_size = 0;
+    m_num_allocations = 0;
 }
 
 inline bool randomly_false_in_debug(bool x)
@@ -1139,8 +1218,7 @@ void SlabAlloc::update_reader_view(size_t file_size)
             m_old_mappings.emplace_back(m_youngest_live_version, std::move(cur_entry.primary_mapping));
             // extension cannot possibly happen if we alread have a xover mapping established
             REALM_ASSERT(!cur_entry.xover_mapping.is_attached());
-            cur_entry.primary_mapping =
-                util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size);
+            cur_entry.primary_mapping = map_section(section_start_offset, section_size);
             m_mapping_version++;
         }
         else { // extension stretches over multiple sections:
@@ -1161,8 +1239,7 @@ void SlabAlloc::update_reader_view(size_t file_size)
                 m_old_mappings.emplace_back(m_youngest_live_version, std::move(cur_entry.primary_mapping));
                 // A xover mapping cannot be present in this case:
                 REALM_ASSERT(!cur_entry.xover_mapping.is_attached());
-                cur_entry.primary_mapping =
-                    util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size);
+                cur_entry.primary_mapping = map_section(section_start_offset, section_size);
                 m_mapping_version++;
             }
 
@@ -1178,8 +1255,7 @@ void SlabAlloc::update_reader_view(size_t file_size)
             for (size_t k = old_num_mappings; k < num_full_mappings; ++k) {
                 const size_t section_start_offset = get_section_base(k);
                 const size_t section_size = 1 << section_shift;
-                m_mappings[k].primary_mapping =
-                    util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size);
+                m_mappings[k].primary_mapping = map_section(section_start_offset, section_size);
             }
 
             // 3. add a final partial mapping if needed
@@ -1187,8 +1263,7 @@ void SlabAlloc::update_reader_view(size_t file_size)
                 REALM_ASSERT(num_mappings == num_full_mappings + 1);
                 const size_t section_start_offset = get_section_base(num_full_mappings);
                 const size_t section_size = file_size - section_start_offset;
-                m_mappings[num_full_mappings].primary_mapping =
-                    util::File::Map<char>(m_file, section_start_offset, File::access_ReadOnly, section_size);
+                m_mappings[num_full_mappings].primary_mapping = map_section(section_start_offset, section_size);
             }
         }
     }
@@ -1221,6 +1296,30 @@ void SlabAlloc::update_reader_view(size_t file_size)
     rebuild_translations(requires_new_translation, old_num_mappings);
 }
 
+util::File::Map<char> SlabAlloc::map_section(size_t section_start_offset, size_t section_size)
+{
+    int map_flags = m_cfg.populate_mappings ? File::map_Populate : 0;
+    util::File::Map<char> mapping(m_file, section_start_offset, File::access_ReadOnly, section_size, map_flags);
+    if (m_cfg.access_hint != File::hint_Normal)
+        mapping.advise(m_cfg.access_hint);
+    return mapping;
+}
+
+void SlabAlloc::advise(util::File::AccessHint hint, ref_type begin, ref_type end) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mapping_mutex);
+    end = std::min(end, ref_type(m_baseline.load(std::memory_order_relaxed)));
+    while (begin < end) {
+        size_t section = get_section_index(begin);
+        if (section >= m_mappings.size())
+            break;
+        size_t section_base = get_section_base(section);
+        size_t section_end = get_section_base(section + 1);
+        m_mappings[section].primary_mapping.advise(hint, begin - section_base, std::min(end, section_end) - begin);
+        begin = section_end;
+    }
+}
+
 size_t SlabAlloc::get_allocated_size() const noexcept
 {
     size_t sz = 0;
@@ -105,6 +105,14 @@ public:
     /// Always initialize the file as if it was a newly
     /// created file and ignore any pre-existing contents. Requires that
     /// Config::session_initiator be true as well.
+    ///
+    /// \var Config::populate_mappings
+    /// Read in the contents of each section of the file when it is
+    /// mapped, instead of on first access (see util::File::map_Populate).
+    ///
+    /// \var Config::access_hint
+    /// How the file is expected to be accessed. The hint is given for the
+    /// file as a whole, and for every mapping of it.
     struct Config {
         bool is_shared = false;
         bool read_only = false;
@@ -113,6 +121,8 @@ public:
         bool session_initiator = false;
         bool clear_file = false;
         bool disable_sync = false;
+        bool populate_mappings = false;
+        util::File::AccessHint access_hint = util::File::hint_Normal;
         const char* encryption_key = nullptr;
     };
 
@@ -300,6 +310,19 @@ public:
     /// by get_mapping_version() below. The mapping version changes whenever a
     /// ref->ptr translation changes, and is used by Group to enforce re-translation.
     void update_reader_view(size_t file_size);
+
+    /// Advise the system about how the part of the file holding the specified
+    /// range of refs is going to be accessed. For example, util::File::hint_WillNeed
+    /// starts reading in the nodes of a subtree that is about to be traversed.
+    /// Refs which are not in the mapped part of the file are ignored, and so is
+    /// the advice for encrypted files. Passing get_access_hint() restores the
+    /// access pattern given when the file was attached.
+    void advise(util::File::AccessHint, ref_type begin = 0, ref_type end = ref_type(-1)) noexcept;
+    util::File::AccessHint get_access_hint() const noexcept
+    {
+        return m_cfg.access_hint;
+    }
+
     void purge_old_mappings(uint64_t oldest_live_version, uint64_t youngest_live_version);
     void init_mapping_management(uint64_t currently_live_version);
 
@@ -323,6 +346,15 @@ public:
         return m_commit_size;
     }
 
+    /// Returns the number of blocks allocated by calls to SlabAlloc::alloc()
+    /// and SlabAlloc::realloc_() since the last call to
+    /// reset_free_space_tracking(). Blocks grown in place by realloc_() are
+    /// not counted.
+    size_t get_num_allocations() const
+    {
+        return m_num_allocations;
+    }
+
     /// Returns the total amount of memory currently allocated in slab area
     size_t get_allocated_size() const noexcept;
 
@@ -489,6 +521,9 @@ private:
     // Main entry points for alloc/free:
     FreeBlock* allocate_block(int size);
     void free_block(ref_type ref, FreeBlock* addr);
+    // grow an allocated block into the free block following it, if any.
+    // returns false if there is not enough room.
+    bool extend_block(ref_type ref, FreeBlock* block, int new_size);
 
     // Searching/manipulating freelists
     FreeList find(int size);
@@ -595,6 +630,8 @@ private:
     // kept open and ref->ptr translations work for other threads..
     std::vector<OldMapping> m_old_mappings;
     std::vector<OldRefTranslation> m_old_translations;
+    // Map a section of the file as configured by m_cfg.
+    util::File::Map<char> map_section(size_t section_start_offset, size_t section_size);
     // Rebuild the ref translations in a thread-safe manner. Save the old one along with it's
     // versioning information for later deletion - 'requires_new_fast_mapping' must be
     // true if there are changes to entries among the existing translations. Must be called
@@ -632,6 +669,7 @@ private:
     Slabs m_slabs;
     Chunks m_free_read_only;
     size_t m_commit_size = 0;
+    size_t m_num_allocations = 0;
 
     bool m_debug_out = false;
 
@@ -24,6 +24,110 @@
 
 using namespace realm;
 
+namespace {
+
+// Backlink lists smaller than this are simply scanned
+constexpr size_t s_positions_min_size = 256;
+
+// The number of times a list is scanned before the positions of its entries
+// are collected. Collecting them costs about as much as this many scans.
+constexpr size_t s_scans_before_positions = 16;
+
+} // anonymous namespace
+
+bool BacklinkPositions::track(const Array& list)
+{
+    if (list.size() < s_positions_min_size)
+        return false;
+    if (!is_tracking(list)) {
+        clear();
+        m_ref = list.get_ref();
+        m_size = list.size();
+    }
+    return true;
+}
+
+size_t BacklinkPositions::find(const Array& list, int64_t key)
+{
+    if (!m_indexed) {
+        if (++m_num_scans <= s_scans_before_positions)
+            return list.find_first(key);
+        build(list); // Throws
+    }
+
+    auto range = m_positions.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second < list.size() && list.get(it->second) == key)
+            return it->second;
+    }
+
+    // The list has been changed by other means
+    build(list); // Throws
+    auto it = m_positions.find(key);
+    return it == m_positions.end() ? not_found : it->second;
+}
+
+void BacklinkPositions::added(const Array& list, int64_t key)
+{
+    if (m_indexed)
+        m_positions.emplace(key, list.size() - 1); // Throws
+    m_ref = list.get_ref();
+    m_size = list.size();
+}
+
+void BacklinkPositions::removed(const Array& list, int64_t key, size_t ndx)
+{
+    if (m_indexed) {
+        // The entry which was last is now at 'ndx'
+        size_t last_ndx = list.size();
+        bool found = erase_position(key, ndx);
+        if (found && ndx != last_ndx) {
+            int64_t moved_key = list.get(ndx);
+            found = erase_position(moved_key, last_ndx);
+            if (found)
+                m_positions.emplace(moved_key, ndx); // Throws
+        }
+        if (!found) {
+            clear();
+            return;
+        }
+    }
+    m_ref = list.get_ref();
+    m_size = list.size();
+}
+
+void BacklinkPositions::clear() noexcept
+{
+    m_ref = 0;
+    m_size = 0;
+    m_num_scans = 0;
+    m_indexed = false;
+    m_positions.clear();
+}
+
+void BacklinkPositions::build(const Array& list)
+{
+    m_positions.clear();
+    m_indexed = false;
+    size_t sz = list.size();
+    m_positions.reserve(sz); // Throws
+    for (size_t i = 0; i < sz; i++)
+        m_positions.emplace(list.get(i), i); // Throws
+    m_indexed = true;
+}
+
+bool BacklinkPositions::erase_position(int64_t key, size_t ndx)
+{
+    auto range = m_positions.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == ndx) {
+            m_positions.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
 // nullify forward links corresponding to any backward links at index 'ndx'.
 void ArrayBacklink::nullify_fwd_links(size_t ndx, CascadeState& state)
 {
@@ -68,7 +172,7 @@ void ArrayBacklink::nullify_fwd_links(size_t ndx, CascadeState& state)
     }
 }
 
-void ArrayBacklink::add(size_t ndx, ObjKey key)
+void ArrayBacklink::add(size_t ndx, ObjKey key, BacklinkPositions* positions)
 {
     uint64_t value = Array::get(ndx);
 
@@ -92,11 +196,15 @@ void ArrayBacklink::add(size_t ndx, ObjKey key)
         backlink_list.init_from_ref(to_ref(value));
         backlink_list.set_parent(this, ndx);
     }
+
+    bool tracked = positions && positions->is_tracking(backlink_list);
     backlink_list.add(key.value); // Throws
+    if (tracked)
+        positions->added(backlink_list, key.value); // Throws
 }
 
 // Return true if the last link was removed
-bool ArrayBacklink::remove(size_t ndx, ObjKey key)
+bool ArrayBacklink::remove(size_t ndx, ObjKey key, BacklinkPositions* positions)
 {
     uint64_t value = Array::get(ndx);
     REALM_ASSERT(value != 0);
@@ -116,11 +224,15 @@ bool ArrayBacklink::remove(size_t ndx, ObjKey key)
     backlink_list.set_parent(this, ndx);
 
     size_t last_ndx = backlink_list.size() - 1;
-    size_t backlink_ndx = backlink_list.find_first(key.value);
+    bool tracked = positions && positions->track(backlink_list);
+    size_t backlink_ndx =
+        tracked ? positions->find(backlink_list, key.value) : backlink_list.find_first(key.value); // Throws
     REALM_ASSERT_3(backlink_ndx, !=, not_found);
     if (backlink_ndx != last_ndx)
         backlink_list.set(backlink_ndx, backlink_list.get(last_ndx));
     backlink_list.truncate(last_ndx); // Throws
+    if (tracked)
+        positions->removed(backlink_list, key.value, backlink_ndx); // Throws
 
     // If there is only one backlink left we can inline it as tagged value
     if (last_ndx == 1) {
@@ -21,7 +21,49 @@
 
 #include <realm/cluster.hpp>
 
+#include <unordered_map>
+
 namespace realm {
+
+/// Positions of the entries of a large backlink list, so that backlinks can
+/// be removed from the list of an object linked to by very many objects
+/// without scanning the list every time. The lists keep their order, so the
+/// file format is not affected.
+///
+/// The target table keeps one of these per backlink column, and it describes
+/// one list at a time. The positions are only collected once a list has been
+/// searched a number of times, and every position is checked against the list
+/// before it is used. If the list turns out to have been changed by other
+/// means, the positions are collected again.
+class BacklinkPositions {
+public:
+    /// Start describing 'list' unless it is already described. Returns false
+    /// if the list is too small to be worth it.
+    bool track(const Array& list);
+    bool is_tracking(const Array& list) const noexcept
+    {
+        return list.get_ref() == m_ref && list.size() == m_size;
+    }
+    /// Index of an entry equal to 'key' in the tracked list, or not_found.
+    size_t find(const Array& list, int64_t key);
+    /// Record that 'key' was appended to the tracked list.
+    void added(const Array& list, int64_t key);
+    /// Record that the entry at 'ndx' of the tracked list was replaced by the
+    /// last entry, and the list truncated.
+    void removed(const Array& list, int64_t key, size_t ndx);
+    void clear() noexcept;
+
+private:
+    ref_type m_ref = 0;
+    size_t m_size = 0;
+    size_t m_num_scans = 0;
+    bool m_indexed = false;
+    std::unordered_multimap<int64_t, size_t> m_positions;
+
+    void build(const Array& list);
+    bool erase_position(int64_t key, size_t ndx);
+};
+
 class ArrayBacklink : public ArrayPayload, private Array {
 public:
     using Array::Array;
@@ -70,8 +112,8 @@ public:
 
     // nullify forward links corresponding to any backward links at index 'ndx'
     void nullify_fwd_links(size_t ndx, CascadeState& state);
-    void add(size_t ndx, ObjKey key);
-    bool remove(size_t ndx, ObjKey key);
+    void add(size_t ndx, ObjKey key, BacklinkPositions* positions = nullptr);
+    bool remove(size_t ndx, ObjKey key, BacklinkPositions* positions = nullptr);
     void erase(size_t ndx);
     size_t get_backlink_count(size_t ndx) const;
     ObjKey get_backlink(size_t ndx, size_t index) const;
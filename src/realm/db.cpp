@@ -24,6 +24,7 @@
 #include <iostream>
 #include <mutex>
 #include <sstream>
+#include <thread>
 #include <type_traits>
 #include <random>
 
@@ -45,6 +46,7 @@
 #ifndef _WIN32
 #include <sys/wait.h>
 #include <sys/time.h>
+#include <signal.h>
 #include <unistd.h>
 #else
 #include <windows.h>
@@ -81,11 +83,9 @@ const uint16_t relaxed_sync_threshold = 50;
 //         `write_fairness`
 // 10      Introducing SharedInfo::history_schema_version.
 // 11      New impl of InterprocessCondVar on windows.
-#ifdef _WIN32
-const uint_fast16_t g_shared_info_version = 11;
-#else
-const uint_fast16_t g_shared_info_version = 10; // version 11 didn't change anything on non-windows platforms
-#endif
+// 12      Write priorities and timeouts require `num_priority_writers`,
+//         `priority_writer_processes` and `abandoned_tickets`.
+const uint_fast16_t g_shared_info_version = 12;
 
 // The following functions are carefully designed for minimal overhead
 // in case of contention among read transactions. In case of contention,
@@ -114,6 +114,13 @@ const uint_fast16_t g_shared_info_version = 10; // version 11 didn't change anyt
 // never change the versioning information, only increment or decrement the
 // count (and do so solely through the use of atomic operations).
 //
+// The count is held per DB instance rather than per transaction: The first
+// transaction in a DB to bind to a version increments the count, and further
+// transactions in the same DB binding to that version only increment a local
+// count kept in the DB. The count in the ringbuffer is decremented when the
+// last of them ends. This keeps the shared cache line out of the common path
+// where many threads in one process read the latest version.
+//
 // There is a race between read transactions incrementing the count field and
 // a write transaction setting the free field. These are mutually exclusive:
 // if a read sees the free field set, it cannot use the entry. As it has already
@@ -210,7 +217,7 @@ public:
     // the ringbuffer is a circular list of ReadCount structures.
     // Entries from old_pos to put_pos are considered live and may
     // have an even value in 'count'. The count indicates the
-    // number of referring transactions times 2.
+    // number of referring DB instances times 2.
     // Entries from after put_pos up till (not including) old_pos
     // are free entries and must have a count of ONE.
     // Cleanup is performed by starting at old_pos and incrementing
@@ -523,6 +530,31 @@ struct alignas(8) DB::SharedInfo {
     std::atomic<uint32_t> next_ticket;
     uint32_t next_served = 0;
 
+    /// Number of writers of high priority waiting for the write lock. Writers
+    /// of normal priority yield to them.
+    std::atomic<uint32_t> num_priority_writers;
+
+    /// The processes with writers of high priority waiting, and the number of
+    /// writers of each. Those of processes which are gone are discounted from
+    /// `num_priority_writers`. Writers which find no free entry are counted in
+    /// `num_unrecorded_priority_writers`, which is never discounted. Guarded by
+    /// the control mutex, as are the changes to `num_priority_writers`.
+    struct PriorityWriterProcess {
+        uint64_t pid;
+        uint32_t num_writers;
+    };
+    static constexpr uint32_t max_priority_writer_processes = 8;
+    uint32_t num_priority_writer_processes = 0;
+    uint32_t num_unrecorded_priority_writers = 0;
+    PriorityWriterProcess priority_writer_processes[max_priority_writer_processes];
+
+    /// Tickets given up by writers which timed out while waiting for their
+    /// turn. They are skipped when advancing `next_served`. Guarded by the
+    /// write mutex.
+    static constexpr uint32_t max_abandoned_tickets = 8;
+    uint32_t num_abandoned_tickets = 0;
+    uint32_t abandoned_tickets[max_abandoned_tickets];
+
     // IMPORTANT: The ringbuffer MUST be the last field in SharedInfo - see above.
     Ringbuffer readers;
 
@@ -562,6 +594,7 @@ DB::SharedInfo::SharedInfo(Durability dura, Replication::HistoryType ht, int hsv
     InterprocessCondVar::init_shared_part(new_commit_available); // Throws
     InterprocessCondVar::init_shared_part(pick_next_writer);     // Throws
     next_ticket = 0;
+    num_priority_writers = 0;
 #ifdef REALM_ASYNC_DAEMON
     InterprocessCondVar::init_shared_part(room_to_write);        // Throws
     InterprocessCondVar::init_shared_part(work_to_do);           // Throws
@@ -1018,6 +1051,17 @@ void DB::do_open(const std::string& path, bool no_create_file, bool is_backend,
             cfg.clear_file = (options.durability == Durability::MemOnly && begin_new_session);
 
             cfg.encryption_key = m_key;
+            cfg.populate_mappings = options.populate_mappings;
+            switch (options.access_pattern) {
+                case DBOptions::AccessPattern::Normal:
+                    break;
+                case DBOptions::AccessPattern::Sequential:
+                    cfg.access_hint = util::File::hint_Sequential;
+                    break;
+                case DBOptions::AccessPattern::Random:
+                    cfg.access_hint = util::File::hint_Random;
+                    break;
+            }
             ref_type top_ref;
             try {
                 top_ref = alloc.attach_file(path, cfg); // Throws
@@ -1436,6 +1480,15 @@ bool DB::compact(bool bump_version_number, util::Optional<const char*> output_en
             File file;
             file.open(tmp_path, File::access_ReadWrite, File::create_Must, 0);
             int incr = bump_version_number ? 1 : 0;
+            // Writing the Realm reads all of it, and mostly in the order it is
+            // laid out in the file, so the system should read ahead
+            // aggressively. The hint applies to the mappings shared by all
+            // transactions of this DB, which is why it is only given here,
+            // where no other transaction can be active.
+            m_alloc.advise(util::File::hint_Sequential);
+            auto restore_access_hint = make_scope_exit([&]() noexcept {
+                m_alloc.advise(m_alloc.get_access_hint());
+            });
             tr->write(file, write_key, info->latest_version_number + incr, true); // Throws
             // Data needs to be flushed to the disk before renaming.
             bool disable_sync = get_disable_sync_to_disk();
@@ -1517,8 +1570,8 @@ void DB::release_all_read_locks() noexcept
     std::lock_guard<std::recursive_mutex> local_lock(m_mutex);
     SharedInfo* r_info = m_reader_map.get_addr();
     for (auto& read_lock : m_local_locks_held) {
-        --m_transaction_count;
-        const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_reader_idx);
+        m_transaction_count -= int(read_lock.m_count);
+        const Ringbuffer::ReadCount& r = r_info->readers.get(read_lock.m_lock.m_reader_idx);
         atomic_double_dec(r.count);
     }
     m_local_locks_held.clear();
@@ -1655,7 +1708,7 @@ void Transaction::set_transact_stage(DB::TransactStage stage) noexcept
                 m_metrics->end_read_transaction(total_size, free_space, num_objects, num_available_versions,
                                                 num_decrypted_pages);
             }
-            m_metrics->start_write_transaction();
+            m_metrics->start_write_transaction(db->m_write_lock_wait_time, db->m_write_queue_depth);
         }
         else if (stage == DB::transact_Ready) {
             m_metrics->end_read_transaction(total_size, free_space, num_objects, num_available_versions,
@@ -1863,12 +1916,17 @@ void DB::release_read_lock(ReadLockInfo& read_lock) noexcept
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
     bool found_match = false;
     // simple linear search and move-last-over if a match is found.
-    // common case should have only a modest number of transactions in play..
+    // common case should have only a modest number of versions in play..
     for (size_t j = 0; j < m_local_locks_held.size(); ++j) {
-        if (m_local_locks_held[j].m_version == read_lock.m_version) {
+        if (m_local_locks_held[j].m_lock.m_version == read_lock.m_version) {
+            found_match = true;
+            if (--m_local_locks_held[j].m_count > 0) {
+                // other transactions in this DB are still bound to the version
+                --m_transaction_count;
+                return;
+            }
             m_local_locks_held[j] = m_local_locks_held.back();
             m_local_locks_held.pop_back();
-            found_match = true;
             break;
         }
     }
@@ -1884,6 +1942,25 @@ void DB::release_read_lock(ReadLockInfo& read_lock) noexcept
 }
 
 
+bool DB::share_local_read_lock(ReadLockInfo& read_lock, version_type version) noexcept
+{
+    // While this DB holds a lock on a ringbuffer entry, the entry cannot be
+    // recycled, so a match on the index is a match on the version, unless a
+    // specific (and by now stale) version is asked for.
+    for (auto& held : m_local_locks_held) {
+        if (held.m_lock.m_reader_idx == read_lock.m_reader_idx) {
+            if (version != std::numeric_limits<version_type>::max() && version != held.m_lock.m_version)
+                return false;
+            ++held.m_count;
+            ++m_transaction_count;
+            read_lock = held.m_lock;
+            return true;
+        }
+    }
+    return false;
+}
+
+
 void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
 {
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
@@ -1892,6 +1969,8 @@ void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
         for (;;) {
             SharedInfo* r_info = m_reader_map.get_addr();
             read_lock.m_reader_idx = r_info->readers.last();
+            if (share_local_read_lock(read_lock, version_id.version))
+                return;
             if (grow_reader_mapping(read_lock.m_reader_idx)) { // Throws
                 // remapping takes time, so retry with a fresh entry
                 continue;
@@ -1905,7 +1984,7 @@ void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
             read_lock.m_version = r.version;
             read_lock.m_top_ref = to_size_t(r.current_top);
             read_lock.m_file_size = to_size_t(r.filesize);
-            m_local_locks_held.emplace_back(read_lock);
+            m_local_locks_held.push_back({read_lock});
             ++m_transaction_count;
             // REALM_ASSERT(m_alloc.matches_section_boundary(read_lock.m_file_size));
             REALM_ASSERT(read_lock.m_file_size > read_lock.m_top_ref);
@@ -1916,6 +1995,8 @@ void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
     for (;;) {
         SharedInfo* r_info = m_reader_map.get_addr();
         read_lock.m_reader_idx = version_id.index;
+        if (share_local_read_lock(read_lock, version_id.version))
+            return;
         if (grow_reader_mapping(read_lock.m_reader_idx)) { // Throws
             // remapping takes time, so retry with a fresh entry
             continue;
@@ -1943,7 +2024,7 @@ void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
         read_lock.m_version = r.version;
         read_lock.m_top_ref = to_size_t(r.current_top);
         read_lock.m_file_size = to_size_t(r.filesize);
-        m_local_locks_held.emplace_back(read_lock);
+        m_local_locks_held.push_back({read_lock});
         ++m_transaction_count;
         // REALM_ASSERT(m_alloc.matches_section_boundary(read_lock.m_file_size));
         REALM_ASSERT(read_lock.m_file_size > read_lock.m_top_ref);
@@ -1951,6 +2032,149 @@ void DB::grab_read_lock(ReadLockInfo& read_lock, VersionID version_id)
     }
 }
 
+namespace {
+
+// Convert a point in time to the absolute wall clock time expected by
+// InterprocessCondVar::wait()
+timespec to_wait_limit(std::chrono::steady_clock::time_point limit)
+{
+    auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(limit - std::chrono::steady_clock::now());
+    timeval tv;
+    gettimeofday(&tv, nullptr);
+    int64_t usec = int64_t(tv.tv_usec) + std::max(remaining.count(), int64_t(0));
+    timespec time_limit;
+    time_limit.tv_sec = tv.tv_sec + time_t(usec / 1000000);
+    time_limit.tv_nsec = long(usec % 1000000) * 1000;
+    return time_limit;
+}
+
+uint64_t get_current_pid()
+{
+#ifdef _WIN32
+    return GetCurrentProcessId();
+#else
+    return getpid();
+#endif
+}
+
+bool process_is_alive(uint64_t pid)
+{
+#if REALM_UWP
+    // Other processes cannot be inspected
+    static_cast<void>(pid);
+    return true;
+#elif defined(_WIN32)
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, DWORD(pid));
+    if (!process)
+        return GetLastError() == ERROR_ACCESS_DENIED;
+    DWORD exit_code = 0;
+    bool alive = GetExitCodeProcess(process, &exit_code) && exit_code == STILL_ACTIVE;
+    CloseHandle(process);
+    return alive;
+#else
+    // A process we may not signal is still alive
+    return kill(pid_t(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+// Must be called with the control mutex locked. Returns false if the writer
+// could not be recorded with its process.
+template <class Info>
+bool add_priority_writer(Info* info, uint64_t pid)
+{
+    info->num_priority_writers.fetch_add(1, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < info->num_priority_writer_processes; ++i) {
+        if (info->priority_writer_processes[i].pid == pid) {
+            ++info->priority_writer_processes[i].num_writers;
+            return true;
+        }
+    }
+    if (info->num_priority_writer_processes < Info::max_priority_writer_processes) {
+        info->priority_writer_processes[info->num_priority_writer_processes++] = {pid, 1};
+        return true;
+    }
+    ++info->num_unrecorded_priority_writers;
+    return false;
+}
+
+// Must be called with the control mutex locked
+template <class Info>
+void remove_priority_writer(Info* info, uint64_t pid, bool recorded)
+{
+    if (!recorded) {
+        --info->num_unrecorded_priority_writers;
+        info->num_priority_writers.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+    for (uint32_t i = 0; i < info->num_priority_writer_processes; ++i) {
+        auto& entry = info->priority_writer_processes[i];
+        if (entry.pid != pid)
+            continue;
+        if (--entry.num_writers == 0)
+            entry = info->priority_writer_processes[--info->num_priority_writer_processes];
+        info->num_priority_writers.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+    // The process was taken for dead, and its writers have been discounted
+    // already
+}
+
+// Discount the writers of high priority of processes which crashed while
+// waiting. Must be called with the control mutex locked.
+template <class Info>
+void discount_dead_priority_writers(Info* info, uint64_t own_pid)
+{
+    uint32_t i = 0;
+    while (i < info->num_priority_writer_processes) {
+        auto& entry = info->priority_writer_processes[i];
+        if (entry.pid == own_pid || process_is_alive(entry.pid)) {
+            ++i;
+            continue;
+        }
+        info->num_priority_writers.fetch_sub(entry.num_writers, std::memory_order_relaxed);
+        entry = info->priority_writer_processes[--info->num_priority_writer_processes];
+    }
+}
+
+// Must be called with the write mutex locked
+template <class Info>
+void skip_abandoned_tickets(Info* info)
+{
+    uint32_t i = 0;
+    while (i < info->num_abandoned_tickets) {
+        int32_t diff = int32_t(info->abandoned_tickets[i] - info->next_served);
+        if (diff > 0) {
+            ++i;
+            continue;
+        }
+        if (diff == 0)
+            ++info->next_served;
+        // the ticket is no longer ahead of us, drop it and start over
+        info->abandoned_tickets[i] = info->abandoned_tickets[--info->num_abandoned_tickets];
+        i = 0;
+    }
+}
+
+} // anonymous namespace
+
+bool DB::lock_write_mutex(util::Optional<std::chrono::steady_clock::time_point> deadline)
+{
+    if (!deadline) {
+        m_writemutex.lock(); // Throws
+        return true;
+    }
+    // InterprocessMutex offers no timed locking, so poll with exponential backoff
+    std::chrono::microseconds backoff(50);
+    while (!m_writemutex.try_lock()) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= *deadline)
+            return false;
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(backoff, *deadline - now));
+        backoff = std::min(backoff * 2, std::chrono::microseconds(10000));
+    }
+    return true;
+}
+
 bool DB::do_try_begin_write()
 {
     // In the non-blocking case, we will only succeed if there is no contention for
@@ -1958,25 +2182,75 @@ bool DB::do_try_begin_write()
     // fairness machinery.
     bool got_the_lock = m_writemutex.try_lock();
     if (got_the_lock) {
+        m_write_ticket_held = false;
+        m_write_lock_wait_time = 0;
+        m_write_queue_depth = 0;
         finish_begin_write();
     }
     return got_the_lock;
 }
 
-void DB::do_begin_write()
+bool DB::do_begin_write(WritePriority priority, util::Optional<std::chrono::steady_clock::time_point> deadline)
 {
     SharedInfo* info = m_file_map.get_addr();
+    MetricTimer wait_timer;
 
     // Get write lock - the write lock is held until do_end_write().
     //
     // We use a ticketing scheme to ensure fairness wrt performing write transactions.
     // (But cannot do that on Windows until we have interprocess condition variables there)
-    uint32_t my_ticket = info->next_ticket.fetch_add(1, std::memory_order_relaxed);
-    m_writemutex.lock(); // Throws
+    //
+    // Writers of high priority do not take a ticket. They announce themselves
+    // in 'num_priority_writers', and whoever holds the turn yields to them.
+    // Writers with a deadline take their ticket only once they hold the write
+    // mutex, as they need the mutex to give the ticket up again on timeout.
+    bool high_priority = priority == WritePriority::High;
+    uint32_t my_ticket = 0;
+    uint64_t pid = get_current_pid();
+    bool recorded = false;
+    if (high_priority) {
+        std::lock_guard<InterprocessMutex> lock(m_controlmutex); // Throws
+        recorded = add_priority_writer(info, pid);
+    }
+    else if (!deadline) {
+        my_ticket = info->next_ticket.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto leave_priority_writers = [&] {
+        std::lock_guard<InterprocessMutex> lock(m_controlmutex); // Throws
+        remove_priority_writer(info, pid, recorded);
+    };
+
+    bool got_the_lock;
+    try {
+        got_the_lock = lock_write_mutex(deadline); // Throws
+    }
+    catch (...) {
+        if (high_priority)
+            leave_priority_writers();
+        throw;
+    }
+    if (high_priority) {
+        leave_priority_writers();
+        if (!got_the_lock)
+            return false;
+        m_write_ticket_held = false;
+        m_write_lock_wait_time = wait_timer.get_elapsed_nanoseconds();
+        m_write_queue_depth = size_t(std::max(int32_t(info->next_ticket.load() - info->next_served), int32_t(0)) +
+                                     info->num_priority_writers.load(std::memory_order_relaxed));
+        finish_begin_write();
+        return true;
+    }
+    if (!got_the_lock)
+        return false;
+    if (deadline)
+        my_ticket = info->next_ticket.fetch_add(1, std::memory_order_relaxed);
 
     // allow for comparison even after wrap around of ticket numbering:
-    int32_t diff = int32_t(my_ticket - info->next_served);
-    bool should_yield = diff > 0; // ticket is in the future
+    auto should_yield = [&] {
+        int32_t diff = int32_t(my_ticket - info->next_served);
+        return diff > 0 || // ticket is in the future
+               info->num_priority_writers.load(std::memory_order_relaxed) > 0;
+    };
     // a) the above comparison is only guaranteed to be correct, if the distance
     //    between my_ticket and info->next_served is less than 2^30. This will
     //    be the case since the distance will be bounded by the number of threads
@@ -1984,45 +2258,60 @@ void DB::do_begin_write()
     // b) we could use 64 bit counters instead, but it is unclear if all platforms
     //    have support for interprocess atomics for 64 bit values.
 
-    timespec time_limit; // only compute the time limit if we're going to use it:
-    if (should_yield) {
-        // This clock is not monotonic, so time can move backwards. This can lead
-        // to a wrong time limit, but the only effect of a wrong time limit is that
-        // we momentarily lose fairness, so we accept it.
-        timeval tv;
-        gettimeofday(&tv, nullptr);
-        time_limit.tv_sec = tv.tv_sec;
-        time_limit.tv_nsec = tv.tv_usec * 1000;
-        time_limit.tv_nsec += 500000000;        // 500 msec wait
-        if (time_limit.tv_nsec >= 1000000000) { // overflow
-            time_limit.tv_nsec -= 1000000000;
-            time_limit.tv_sec += 1;
+    // We yield for at most 500 msec before taking the turn anyway. This keeps a
+    // writer which crashed while waiting from stalling everybody else.
+    bool yielded = false;
+    std::chrono::steady_clock::time_point fairness_limit;
+    while (should_yield()) {
+        auto now = std::chrono::steady_clock::now();
+        if (!yielded) {
+            fairness_limit = now + std::chrono::milliseconds(500);
+            yielded = true;
         }
+        auto limit = (deadline && *deadline < fairness_limit) ? *deadline : fairness_limit;
+        if (now >= limit)
+            break;
+        timespec time_limit = to_wait_limit(limit);
+        m_pick_next_writer.wait(m_writemutex, &time_limit);
     }
 
-    while (should_yield) {
-
-        m_pick_next_writer.wait(m_writemutex, &time_limit);
-        timeval tv;
-        gettimeofday(&tv, nullptr);
-        if (time_limit.tv_sec < tv.tv_sec ||
-            (time_limit.tv_sec == tv.tv_sec && time_limit.tv_nsec < tv.tv_usec * 1000)) {
-            // Timeout!
-            break;
+    if (deadline && should_yield() && std::chrono::steady_clock::now() >= *deadline) {
+        // Give up the ticket, so that those behind us need not wait for it to
+        // time out. If there is no room to record it, they will.
+        int32_t diff = int32_t(my_ticket - info->next_served);
+        if (diff == 0) {
+            // it is our turn, but we were yielding to writers of high priority
+            ++info->next_served;
+            skip_abandoned_tickets(info);
+            m_pick_next_writer.notify_all();
+        }
+        else if (diff > 0 && info->num_abandoned_tickets < SharedInfo::max_abandoned_tickets) {
+            info->abandoned_tickets[info->num_abandoned_tickets++] = my_ticket;
         }
-        diff = int32_t(my_ticket - info->next_served);
-        should_yield = diff > 0; // ticket is in the future, so yield to someone else
+        m_writemutex.unlock();
+        return false;
     }
 
     // we may get here because a) it's our turn, b) we timed out
     // we don't distinguish, satisfied that event b) should be rare.
     // In case b), we have to *make* it our turn. Failure to do so could leave us
-    // with 'next_served' permanently trailing 'next_ticket'.
+    // with 'next_served' permanently trailing 'next_ticket'. Likewise, writers
+    // of high priority of a process which crashed while they waited must not
+    // stall everybody after us, so they are discounted. Those which are still
+    // waiting keep their priority.
     //
     // In doing so, we may bypass other waiters, hence the condition for yielding
     // should take this situation into account by comparing with '>' instead of '!='
+    if (info->num_priority_writers.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<InterprocessMutex> lock(m_controlmutex); // Throws
+        discount_dead_priority_writers(info, pid);
+    }
     info->next_served = my_ticket;
+    m_write_ticket_held = true;
+    m_write_lock_wait_time = wait_timer.get_elapsed_nanoseconds();
+    m_write_queue_depth = size_t(std::max(int32_t(info->next_ticket.load() - my_ticket - 1), int32_t(0)));
     finish_begin_write();
+    return true;
 }
 
 void DB::finish_begin_write()
@@ -2056,7 +2345,10 @@ void DB::finish_begin_write()
 void DB::do_end_write() noexcept
 {
     SharedInfo* info = m_file_map.get_addr();
-    info->next_served++;
+    if (m_write_ticket_held) {
+        info->next_served++;
+        skip_abandoned_tickets(info);
+    }
     m_pick_next_writer.notify_all();
 
     std::lock_guard<std::recursive_mutex> local_lock(m_mutex);
@@ -2583,6 +2875,108 @@ TransactionRef DB::start_write(bool nonblocking)
     else {
         do_begin_write();
     }
+    return create_write_transaction();
+}
+
+TransactionRef DB::start_write(WritePriority priority, util::Optional<std::chrono::milliseconds> timeout)
+{
+    util::Optional<std::chrono::steady_clock::time_point> deadline;
+    if (timeout)
+        deadline = std::chrono::steady_clock::now() + *timeout;
+    if (!do_begin_write(priority, deadline)) {
+        return TransactionRef();
+    }
+    return create_write_transaction();
+}
+
+namespace {
+
+// Collects the tables changed by the commits passed when advancing a transaction
+class ChangedTablesObserver : public _impl::NullInstructionObserver {
+public:
+    bool select_table(TableKey key)
+    {
+        if (std::find(m_changed.begin(), m_changed.end(), key) == m_changed.end())
+            m_changed.push_back(key); // Throws
+        return true;
+    }
+    bool insert_group_level_table(TableKey)
+    {
+        m_schema_changed = true;
+        return true;
+    }
+    bool erase_group_level_table(TableKey)
+    {
+        m_schema_changed = true;
+        return true;
+    }
+    bool rename_group_level_table(TableKey)
+    {
+        m_schema_changed = true;
+        return true;
+    }
+
+    bool changed_any_of(const std::vector<TableKey>& tables) const
+    {
+        if (m_schema_changed)
+            return true;
+        for (auto key : tables) {
+            if (std::find(m_changed.begin(), m_changed.end(), key) != m_changed.end())
+                return true;
+        }
+        return false;
+    }
+
+private:
+    std::vector<TableKey> m_changed;
+    bool m_schema_changed = false;
+};
+
+} // anonymous namespace
+
+DB::version_type DB::write_optimistic(util::FunctionRef<void(Transaction&)> prepare,
+                                      util::FunctionRef<void(Transaction&)> apply, int max_retries)
+{
+    TransactionRef tr = start_read();
+    for (int attempt = 0; attempt < max_retries; ++attempt) {
+        std::vector<TableKey> tables_read;
+        {
+            Group& group = *tr;
+            group.m_table_access_log = &tables_read;
+            auto stop_logging = util::make_scope_exit([&]() noexcept {
+                group.m_table_access_log = nullptr;
+            });
+            prepare(*tr); // Throws
+        }
+        // Changing a link also changes the backlinks in the target table
+        for (size_t i = 0, n = tables_read.size(); i < n; ++i) {
+            ConstTableRef table = tr->get_table(tables_read[i]);
+            table->for_each_backlink_column([&](ColKey col) {
+                TableKey origin = table->get_opposite_table_key(col);
+                if (std::find(tables_read.begin(), tables_read.end(), origin) == tables_read.end())
+                    tables_read.push_back(origin);
+                return false;
+            });
+        }
+
+        ChangedTablesObserver observer;
+        tr->promote_to_write(&observer); // Throws
+        if (!observer.changed_any_of(tables_read)) {
+            apply(*tr);          // Throws
+            return tr->commit(); // Throws
+        }
+        tr->rollback_and_continue_as_read(); // Throws
+    }
+
+    // Too much contention, so leave nothing to chance
+    tr->promote_to_write(); // Throws
+    prepare(*tr);           // Throws
+    apply(*tr);             // Throws
+    return tr->commit();    // Throws
+}
+
+TransactionRef DB::create_write_transaction()
+{
     {
         std::lock_guard<std::recursive_mutex> local_lock(m_mutex);
         if (!is_attached()) {
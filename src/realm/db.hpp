@@ -19,10 +19,12 @@
 #ifndef REALM_GROUP_SHARED_HPP
 #define REALM_GROUP_SHARED_HPP
 
+#include <chrono>
 #include <functional>
 #include <cstdint>
 #include <limits>
 #include <realm/util/features.h>
+#include <realm/util/function_ref.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/util/interprocess_condvar.hpp>
 #include <realm/util/interprocess_mutex.hpp>
@@ -220,12 +222,33 @@ public:
     struct BadVersion;
 
 
+    /// Writers waiting for the write lock are let in in the order in which
+    /// they asked for it, except that writers of high priority go ahead of
+    /// all waiting writers of normal priority.
+    enum class WritePriority { Normal, High };
+
     /// Transactions are obtained from one of the following 3 methods:
     TransactionRef start_read(VersionID = VersionID());
     TransactionRef start_frozen(VersionID = VersionID());
     // If nonblocking is true and a write transaction is already active,
     // an invalid TransactionRef is returned.
     TransactionRef start_write(bool nonblocking = false);
+    // Wait for the write lock with the given priority. If a timeout is given
+    // and the write lock cannot be obtained within it, an invalid
+    // TransactionRef is returned.
+    TransactionRef start_write(WritePriority, util::Optional<std::chrono::milliseconds> timeout = util::none);
+
+    // Run a write transaction, doing the reading outside the write lock.
+    // \a prepare is called in a read transaction, and \a apply in the same
+    // transaction promoted to a write transaction at the latest version, which
+    // is then committed. If another commit has changed any of the tables
+    // accessed by \a prepare in the meantime, \a prepare is called again at
+    // the newer version. After \a max_retries such conflicts, \a prepare is
+    // called with the write lock held. Anything to be passed from \a prepare
+    // to \a apply must be captured by the caller. Requires history. Returns
+    // the version committed.
+    version_type write_optimistic(util::FunctionRef<void(Transaction&)> prepare,
+                                  util::FunctionRef<void(Transaction&)> apply, int max_retries = 3);
 
 
     // report statistics of last commit done on THIS DB.
@@ -382,6 +405,12 @@ private:
         ref_type m_top_ref = 0;
         size_t m_file_size = 0;
     };
+    // A read lock on a ringbuffer entry held by this DB on behalf of one or more
+    // transactions bound to the same version.
+    struct LocalReadLock {
+        ReadLockInfo m_lock;
+        size_t m_count = 1;
+    };
     class ReadLockGuard;
 
     // Member variables
@@ -389,7 +418,7 @@ private:
     size_t m_locked_space = 0;
     size_t m_used_space = 0;
     uint_fast32_t m_local_max_entry = 0; // highest version observed by this DB
-    std::vector<ReadLockInfo> m_local_locks_held; // tracks all read locks held by this DB
+    std::vector<LocalReadLock> m_local_locks_held; // tracks all read locks held by this DB
     util::File m_file;
     util::File::Map<SharedInfo> m_file_map; // Never remapped, provides access to everything but the ringbuffer
     util::File::Map<SharedInfo> m_reader_map; // provides access to ringbuffer, remapped as needed when it grows
@@ -413,6 +442,9 @@ private:
 #endif
     util::InterprocessCondVar m_new_commit_available;
     util::InterprocessCondVar m_pick_next_writer;
+    bool m_write_ticket_held = false; // the current writer was let in by ticket
+    metrics::nanosecond_storage_t m_write_lock_wait_time = 0; // for the current writer
+    size_t m_write_queue_depth = 0; // writers waiting when the current writer was let in
     std::function<void(int, int)> m_upgrade_callback;
 
     std::shared_ptr<metrics::Metrics> m_metrics;
@@ -487,13 +519,22 @@ private:
     // call to grab_read_lock().
     void release_read_lock(ReadLockInfo&) noexcept;
 
+    // Bind to a read lock already held by this DB on the ringbuffer entry given
+    // by the read lock info, if it is bound to the given version, or to any
+    // version if none is given. Return false if there is no such lock.
+    bool share_local_read_lock(ReadLockInfo&, version_type) noexcept;
+
     // Release all read locks held by this DB object. After release, further calls to
     // release_read_lock for locks already released must be avoided.
     void release_all_read_locks() noexcept;
 
     /// return true if write transaction can commence, false otherwise.
     bool do_try_begin_write();
-    void do_begin_write();
+    /// return false if the write lock could not be obtained before the deadline.
+    bool do_begin_write(WritePriority = WritePriority::Normal,
+                        util::Optional<std::chrono::steady_clock::time_point> deadline = util::none);
+    bool lock_write_mutex(util::Optional<std::chrono::steady_clock::time_point> deadline);
+    TransactionRef create_write_transaction();
     version_type do_commit(Transaction&);
     void do_end_write() noexcept;
 
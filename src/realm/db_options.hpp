@@ -101,6 +101,20 @@ struct DBOptions {
     /// is exceeded without being consumed, only the most recent entries will be stored.
     size_t metrics_buffer_size;
 
+    /// How the Realm file is expected to be read, passed on to the operating
+    /// system for the file and its memory mappings. Random disables the
+    /// read-ahead which otherwise comes with every page fault, which is a
+    /// waste when mostly looking up individual objects in a large file.
+    /// Sequential reads ahead aggressively.
+    enum class AccessPattern { Normal, Sequential, Random };
+    AccessPattern access_pattern = AccessPattern::Normal;
+
+    /// If set, the Realm file is read into memory as it is mapped, instead of
+    /// page by page as it is first accessed. This makes opening a large file
+    /// slower, but avoids the page faults when accessing it afterwards. Has no
+    /// effect for encrypted files.
+    bool populate_mappings = false;
+
     /// sys_tmp_dir will be used if the temp_dir is empty when creating DBOptions.
     /// It must be writable and allowed to create pipe/fifo file on it.
     /// set_sys_tmp_dir is not a thread-safe call and it is only supposed to be called once
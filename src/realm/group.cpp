@@ -828,6 +828,11 @@ Table* Group::do_get_table(size_t table_ndx)
         if (!table)
             table = create_table_accessor(table_ndx); // Throws
     }
+    if (REALM_UNLIKELY(m_table_access_log)) {
+        TableKey key = table->get_key();
+        if (std::find(m_table_access_log->begin(), m_table_access_log->end(), key) == m_table_access_log->end())
+            m_table_access_log->push_back(key); // Throws
+    }
     return table;
 }
 
@@ -634,6 +634,8 @@ private:
     std::function<void()> m_schema_change_handler;
     std::shared_ptr<metrics::Metrics> m_metrics;
     size_t m_total_rows;
+    // If set, the keys of the tables accessed are recorded here
+    std::vector<TableKey>* m_table_access_log = nullptr;
 
     class TableRecycler : public std::vector<Table*> {
     public:
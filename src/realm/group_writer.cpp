@@ -309,6 +309,7 @@ ref_type GroupWriter::write_group()
     bool is_shared = m_group.m_is_shared;
 #if REALM_METRICS
     std::unique_ptr<MetricTimer> fsync_timer = Metrics::report_write_time(m_group);
+    Metrics::report_commit_size(m_group, m_alloc.get_commit_size(), m_alloc.get_num_allocations());
 #endif // REALM_METRICS
 
 #if REALM_ALLOC_DEBUG
@@ -320,6 +321,12 @@ ref_type GroupWriter::write_group()
     read_in_freelist();
     // Now, 'm_size_map' holds all free elements candidate for recycling
 
+    // Every array to be written is in the slab, so it cannot exceed what has
+    // been allocated there
+    m_expected_size = m_alloc.get_commit_size();
+    // Writing through the file only pays off when the arrays go into extents
+    m_use_write_buffer = m_expected_size >= min_extent_size && !m_alloc.get_file().get_encryption_key();
+
     Array& top = m_group.m_top;
 #if REALM_ALLOC_DEBUG
     std::cout << "    In-file freelist after merge:  " << m_size_map.size() << std::endl;
@@ -356,6 +363,12 @@ ref_type GroupWriter::write_group()
         }
     }
 
+    release_extent();
+    flush_write_buffer();
+#if REALM_METRICS
+    Metrics::report_extent_size(m_group, m_extent_allocated);
+#endif // REALM_METRICS
+
 #if REALM_ALLOC_DEBUG
     std::cout << "    Freelist size after allocations: " << m_size_map.size() << std::endl;
 #endif
@@ -689,6 +702,13 @@ size_t GroupWriter::get_free_space(size_t size)
 {
     REALM_ASSERT_3(size % 8, ==, 0); // 8-byte alignment
 
+    size_t pos = alloc_from_extent(size);
+    if (!pos && m_expected_size >= min_extent_size && take_extent(size))
+        pos = alloc_from_extent(size);
+    m_expected_size -= std::min(m_expected_size, size);
+    if (pos)
+        return pos;
+
     auto p = reserve_free_space(size);
 
     // Claim space from identified chunk
@@ -710,6 +730,55 @@ size_t GroupWriter::get_free_space(size_t size)
     return chunk_pos;
 }
 
+size_t GroupWriter::alloc_from_extent(size_t size)
+{
+    if (m_extent_end - m_extent_pos < size)
+        return 0;
+    size_t pos = m_alloc.find_section_in_range(m_extent_pos, m_extent_end - m_extent_pos, size);
+    if (pos == 0)
+        return 0;
+    if (pos != m_extent_pos) {
+        // Skipped ahead to the next section
+        m_size_map.emplace(pos - m_extent_pos, m_extent_pos);
+    }
+    m_extent_pos = pos + size;
+    m_extent_allocated += size;
+    return pos;
+}
+
+bool GroupWriter::take_extent(size_t size)
+{
+    release_extent();
+    size_t extent_size = (std::max(m_expected_size, size) + 7) & ~size_t(7);
+    auto it = m_size_map.lower_bound(extent_size);
+    if (it == m_size_map.end()) {
+        // No chunk can hold the rest of the commit, so it is split over the
+        // chunks that fit best, as long as they are not too small. Taking the
+        // largest chunk, which is usually the one at the end of the file,
+        // would leave the smaller chunks unused and make the file grow.
+        it = m_size_map.lower_bound(std::max(size, min_extent_size));
+        if (it == m_size_map.end())
+            return false;
+        extent_size = it->first;
+    }
+    // Only what is needed is taken, so the rest of the chunk remains available
+    size_t chunk_pos = it->second;
+    size_t rest = it->first - extent_size;
+    m_size_map.erase(it);
+    if (rest > 0)
+        m_size_map.emplace(rest, chunk_pos + extent_size);
+    m_extent_pos = chunk_pos;
+    m_extent_end = chunk_pos + extent_size;
+    return true;
+}
+
+void GroupWriter::release_extent()
+{
+    if (m_extent_end > m_extent_pos)
+        m_size_map.emplace(m_extent_end - m_extent_pos, m_extent_pos);
+    m_extent_pos = m_extent_end = 0;
+}
+
 
 inline GroupWriter::FreeListElement GroupWriter::split_freelist_chunk(FreeListElement it, size_t alloc_pos)
 {
@@ -868,6 +937,20 @@ ref_type GroupWriter::write_array(const char* data, size_t size, uint32_t checks
     // Get position of free space to write in (expanding file if needed)
     size_t pos = get_free_space(size);
 
+    if (m_use_write_buffer) {
+        if (pos != m_write_buffer_pos + m_write_buffer.size() ||
+            m_write_buffer.size() + size > write_buffer_size)
+            flush_write_buffer(); // Throws
+        if (m_write_buffer.empty())
+            m_write_buffer_pos = pos;
+        size_t offset = m_write_buffer.size();
+        m_write_buffer.resize(offset + size);
+        char* dest_addr = m_write_buffer.data() + offset;
+        memcpy(dest_addr, &checksum, 4);
+        memcpy(dest_addr + 4, data + 4, size - 4);
+        return to_ref(pos);
+    }
+
     // Write the block
     MapWindow* window = get_window(pos, size);
     char* dest_addr = window->translate(pos);
@@ -882,6 +965,18 @@ ref_type GroupWriter::write_array(const char* data, size_t size, uint32_t checks
 }
 
 
+void GroupWriter::flush_write_buffer()
+{
+    if (m_write_buffer.empty())
+        return;
+    File& file = m_alloc.get_file();
+    file.seek(m_write_buffer_pos);                            // Throws
+    file.write(m_write_buffer.data(), m_write_buffer.size()); // Throws
+    m_write_buffer.clear();
+    m_written_to_file = true;
+}
+
+
 void GroupWriter::write_array_at(MapWindow* window, ref_type ref, const char* data, size_t size)
 {
     size_t pos = size_t(ref);
@@ -934,8 +1029,11 @@ void GroupWriter::commit(ref_type new_top_ref)
     // stable storage before flipping the slot selector
     window->encryption_write_barrier(&file_header.m_top_ref[slot_selector],
                                      sizeof(file_header.m_top_ref[slot_selector]));
-    if (!disable_sync)
+    if (!disable_sync) {
+        if (m_written_to_file)
+            m_alloc.get_file().sync();
         sync_all_mappings();
+    }
 
     // Flip the slot selector bit.
     using type_2 = std::remove_reference<decltype(file_header.m_flags)>::type;
@@ -125,6 +125,30 @@ private:
     std::multimap<size_t, size_t> m_size_map;
     using FreeListElement = std::multimap<size_t, size_t>::iterator;
 
+    // Free space from which the arrays of a large commit are allocated one
+    // after the other, in the order they are written. The arrays are written
+    // bottom up, so this places children next to their parents, and the data
+    // of the commit ends up in a few long runs instead of scattered over the
+    // file.
+    size_t m_extent_pos = 0;
+    size_t m_extent_end = 0;
+    // Upper bound on the size of the arrays still to be written
+    size_t m_expected_size = 0;
+    // Total size of the arrays allocated from extents
+    size_t m_extent_allocated = 0;
+    // Commits expected to write less than this are not given an extent
+    static constexpr size_t min_extent_size = 64 * 1024;
+
+    // Arrays written back to back are collected here and written to the file
+    // with a single call instead of being copied through a mapping one at a
+    // time. Only used for commits large enough to get an extent, and not for
+    // encrypted files, which must go through the mappings.
+    std::vector<char> m_write_buffer;
+    size_t m_write_buffer_pos = 0;
+    bool m_use_write_buffer = false;
+    bool m_written_to_file = false;
+    static constexpr size_t write_buffer_size = 1024 * 1024;
+
     void read_in_freelist();
     size_t recreate_freelist(size_t reserve_pos);
     // Currently cached memory mappings. We keep as many as 16 1MB windows
@@ -182,6 +206,22 @@ private:
     /// size, and `chunk_size` is the size of that chunk.
     FreeListElement extend_free_space(size_t requested_size);
 
+    /// Allocate a chunk of the specified size from the current extent,
+    /// if it has room. Returns 0 if not.
+    size_t alloc_from_extent(size_t size);
+
+    /// Replace the current extent by space for the rest of the commit, taken
+    /// from the smallest chunk of free space which can hold it, or else by the
+    /// smallest chunk which is not too small. Returns false if no chunk is
+    /// taken.
+    bool take_extent(size_t size);
+
+    /// Return what is left of the current extent to the free space.
+    void release_extent();
+
+    /// Write the contents of the write buffer to the file.
+    void flush_write_buffer();
+
     void write_array_at(MapWindow* window, ref_type, const char* data, size_t size);
     FreeListElement split_freelist_chunk(FreeListElement, size_t alloc_pos);
 };
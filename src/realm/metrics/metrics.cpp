@@ -62,10 +62,12 @@ void Metrics::start_read_transaction()
     m_pending_read = std::make_unique<TransactionInfo>(TransactionInfo::read_transaction);
 }
 
-void Metrics::start_write_transaction()
+void Metrics::start_write_transaction(nanosecond_storage_t lock_wait_time, size_t write_queue_depth)
 {
     REALM_ASSERT_DEBUG(!m_pending_write);
     m_pending_write = std::make_unique<TransactionInfo>(TransactionInfo::write_transaction);
+    m_pending_write->m_lock_wait_time = lock_wait_time;
+    m_pending_write->m_write_queue_depth = write_queue_depth;
 }
 
 void Metrics::end_read_transaction(size_t total_size, size_t free_space, size_t num_objects, size_t num_versions,
@@ -116,6 +118,29 @@ std::unique_ptr<MetricTimer> Metrics::report_write_time(const Group& g)
     return nullptr;
 }
 
+void Metrics::report_commit_size(const Group& g, size_t commit_size, size_t num_allocations)
+{
+    std::shared_ptr<Metrics> instance = g.get_metrics();
+    if (instance) {
+        REALM_ASSERT_DEBUG(instance->m_transaction_info);
+        if (instance->m_pending_write) {
+            instance->m_pending_write->m_commit_size = commit_size;
+            instance->m_pending_write->m_num_allocations = num_allocations;
+        }
+    }
+}
+
+void Metrics::report_extent_size(const Group& g, size_t extent_size)
+{
+    std::shared_ptr<Metrics> instance = g.get_metrics();
+    if (instance) {
+        REALM_ASSERT_DEBUG(instance->m_transaction_info);
+        if (instance->m_pending_write) {
+            instance->m_pending_write->m_extent_size = extent_size;
+        }
+    }
+}
+
 
 std::unique_ptr<Metrics::QueryInfoList> Metrics::take_queries()
 {
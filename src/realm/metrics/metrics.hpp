@@ -43,13 +43,15 @@ public:
     void add_transaction(TransactionInfo info);
 
     void start_read_transaction();
-    void start_write_transaction();
+    void start_write_transaction(nanosecond_storage_t lock_wait_time = 0, size_t write_queue_depth = 0);
     void end_read_transaction(size_t total_size, size_t free_space, size_t num_objects, size_t num_versions,
                               size_t num_decrypted_pages);
     void end_write_transaction(size_t total_size, size_t free_space, size_t num_objects, size_t num_versions,
                                size_t num_decrypted_pages);
     static std::unique_ptr<MetricTimer> report_fsync_time(const Group& g);
     static std::unique_ptr<MetricTimer> report_write_time(const Group& g);
+    static void report_commit_size(const Group& g, size_t commit_size, size_t num_allocations);
+    static void report_extent_size(const Group& g, size_t extent_size);
 
     using QueryInfoList = util::FixedSizeBuffer<QueryInfo>;
     using TransactionInfoList = util::FixedSizeBuffer<TransactionInfo>;
@@ -28,6 +28,11 @@ TransactionInfo::TransactionInfo(TransactionInfo::TransactionType type)
     , m_type(type)
     , m_num_versions(0)
     , m_num_decrypted_pages(0)
+    , m_lock_wait_time(0)
+    , m_write_queue_depth(0)
+    , m_commit_size(0)
+    , m_num_allocations(0)
+    , m_extent_size(0)
 {
 #if REALM_METRICS
     if (m_type == write_transaction) {
@@ -92,6 +97,31 @@ size_t TransactionInfo::get_num_decrypted_pages() const
     return m_num_decrypted_pages;
 }
 
+nanosecond_storage_t TransactionInfo::get_lock_wait_time_nanoseconds() const
+{
+    return m_lock_wait_time;
+}
+
+size_t TransactionInfo::get_write_queue_depth() const
+{
+    return m_write_queue_depth;
+}
+
+size_t TransactionInfo::get_commit_size() const
+{
+    return m_commit_size;
+}
+
+size_t TransactionInfo::get_num_allocations() const
+{
+    return m_num_allocations;
+}
+
+size_t TransactionInfo::get_extent_size() const
+{
+    return m_extent_size;
+}
+
 void TransactionInfo::update_stats(size_t disk_size, size_t free_space, size_t total_objects,
                                    size_t available_versions, size_t num_decrypted_pages)
 {
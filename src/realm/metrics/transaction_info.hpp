@@ -47,6 +47,16 @@ public:
     size_t get_total_objects() const;
     size_t get_num_available_versions() const;
     size_t get_num_decrypted_pages() const;
+    // time spent waiting for the write lock, not included in the transaction time
+    nanosecond_storage_t get_lock_wait_time_nanoseconds() const;
+    // number of writers waiting for the write lock when it was obtained
+    size_t get_write_queue_depth() const;
+    // memory allocated for the arrays modified by the transaction, when committed
+    size_t get_commit_size() const;
+    // number of arrays allocated or reallocated by the transaction, when committed
+    size_t get_num_allocations() const;
+    // size of the arrays written one after the other in long runs, when committed
+    size_t get_extent_size() const;
 
 private:
     MetricTimerResult m_transaction_time;
@@ -60,6 +70,11 @@ private:
     TransactionType m_type;
     size_t m_num_versions;
     size_t m_num_decrypted_pages;
+    nanosecond_storage_t m_lock_wait_time;
+    size_t m_write_queue_depth;
+    size_t m_commit_size;
+    size_t m_num_allocations;
+    size_t m_extent_size;
 
     friend class Metrics;
     void update_stats(size_t disk_size, size_t free_space, size_t total_objects, size_t available_versions,
@@ -106,12 +106,15 @@ void Node::alloc(size_t init_size, size_t new_width)
         header = mem_ref.get_addr();
         set_capacity_in_header(new_capacity_bytes, header);
 
-        // Update this accessor and its ancestors
-        m_ref = mem_ref.get_ref();
-        m_data = get_data_from_header(header);
-        // FIXME: Trouble when this one throws. We will then leave
-        // this array instance in a corrupt state
-        update_parent(); // Throws
+        // Update this accessor and its ancestors, unless the array was
+        // grown in place
+        if (mem_ref.get_ref() != m_ref) {
+            m_ref = mem_ref.get_ref();
+            m_data = get_data_from_header(header);
+            // FIXME: Trouble when this one throws. We will then leave
+            // this array instance in a corrupt state
+            update_parent(); // Throws
+        }
     }
 
     // Update header
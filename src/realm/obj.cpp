@@ -1657,7 +1657,9 @@ void Obj::add_backlink(ColKey backlink_col_key, ObjKey origin_key)
     backlinks.set_parent(&fields, backlink_col_ndx.val + 1);
     backlinks.init_from_parent();
 
-    backlinks.add(m_row_ndx, origin_key);
+    auto& positions = m_table->m_backlink_positions;
+    auto it = positions.find(backlink_col_key);
+    backlinks.add(m_row_ndx, origin_key, it == positions.end() ? nullptr : &it->second);
 
     REALM_ASSERT(!fields.has_missing_parent_update());
 }
@@ -1676,7 +1678,7 @@ bool Obj::remove_one_backlink(ColKey backlink_col_key, ObjKey origin_key)
     backlinks.set_parent(&fields, backlink_col_ndx.val + 1);
     backlinks.init_from_parent();
 
-    return backlinks.remove(m_row_ndx, origin_key);
+    return backlinks.remove(m_row_ndx, origin_key, &m_table->m_backlink_positions[backlink_col_key]);
 }
 
 namespace {
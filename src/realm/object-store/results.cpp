@@ -322,6 +322,12 @@ util::Optional<Obj> Results::try_get(size_t row_ndx)
             }
             REALM_FALLTHROUGH;
         case Mode::Query:
+            if (evaluate_query_lazily(row_ndx)) {
+                if (row_ndx < m_lazy_keys.size())
+                    return m_table->get_object(m_lazy_keys[row_ndx]);
+                break;
+            }
+            REALM_FALLTHROUGH;
         case Mode::TableView:
             do_evaluate_query_if_needed();
             if (row_ndx >= m_table_view.size())
@@ -367,6 +373,12 @@ Mixed Results::get_any(size_t ndx)
             }
             REALM_FALLTHROUGH;
         case Mode::Query:
+            if (evaluate_query_lazily(ndx)) {
+                if (ndx < m_lazy_keys.size())
+                    return Mixed(ObjLink(m_table->get_key(), m_lazy_keys[ndx]));
+                break;
+            }
+            REALM_FALLTHROUGH;
         case Mode::TableView: {
             do_evaluate_query_if_needed();
             if (ndx >= m_table_view.size())
@@ -478,6 +490,40 @@ void Results::do_evaluate_query_if_needed(bool wants_notifications)
     }
 }
 
+void Results::set_evaluation_policy(EvaluationPolicy policy)
+{
+    util::CheckedUniqueLock lock(m_mutex);
+    m_evaluation_policy = policy;
+    m_lazy_keys.clear();
+    m_lazy_versions.clear();
+}
+
+bool Results::evaluate_query_lazily(size_t ndx)
+{
+    if (m_mode != Mode::Query || m_evaluation_policy != EvaluationPolicy::Lazy ||
+        m_update_policy != UpdatePolicy::Auto || !m_descriptor_ordering.is_empty() ||
+        !m_query.produces_results_in_table_order() || m_realm->audit_context())
+        return false;
+    if (m_notifier && m_notifier->get_tableview(m_table_view)) {
+        m_mode = Mode::TableView;
+        return false;
+    }
+
+    // Start over if anything the query depends on has changed since the last access
+    auto versions = m_query.sync_view_if_needed();
+    if (!(versions == m_lazy_versions)) {
+        m_lazy_cursor = QueryCursor(m_query);
+        m_lazy_keys.clear();
+        m_lazy_versions = std::move(versions);
+    }
+    if (ndx >= m_lazy_keys.size()) {
+        // Fetch a few matches beyond the requested one, as objects are usually accessed in order
+        constexpr size_t min_batch_size = 64;
+        m_lazy_cursor.next(std::max(ndx + 1 - m_lazy_keys.size(), min_batch_size), m_lazy_keys);
+    }
+    return true;
+}
+
 template <>
 size_t Results::index_of(Obj const& row)
 {
@@ -1313,9 +1359,12 @@ Results Results::freeze(std::shared_ptr<Realm> const& frozen_realm)
             // include them here.
             return Results(frozen_realm, std::move(frozen_ls));
         }
-        case Mode::Query:
-            return Results(frozen_realm, *frozen_realm->import_copy_of(m_query, PayloadPolicy::Copy),
-                           m_descriptor_ordering);
+        case Mode::Query: {
+            Results results(frozen_realm, *frozen_realm->import_copy_of(m_query, PayloadPolicy::Copy),
+                            m_descriptor_ordering);
+            results.set_evaluation_policy(m_evaluation_policy);
+            return results;
+        }
         case Mode::TableView: {
             Results results(frozen_realm, *frozen_realm->import_copy_of(m_table_view, PayloadPolicy::Copy),
                             m_descriptor_ordering);
@@ -300,6 +300,17 @@ public:
         m_update_policy = policy;
     }
 
+    enum class EvaluationPolicy {
+        Full, // Run the query to completion and keep all matches in a TableView
+        Lazy, // Find matches incrementally, only as far as the highest index accessed
+    };
+    // Lazy evaluation applies to Results backed by a query on a table with no
+    // sort, distinct or limit. Accessing an object by index then only runs the
+    // query up to that object, which is useful when paging through the first
+    // few objects of a large result set. Once an async query has delivered a
+    // TableView, that is used instead.
+    void set_evaluation_policy(EvaluationPolicy policy) REQUIRES(!m_mutex);
+
 private:
     std::shared_ptr<Realm> m_realm;
     mutable util::CopyableAtomic<const ObjectSchema*> m_object_schema = nullptr;
@@ -316,6 +327,13 @@ private:
 
     Mode m_mode GUARDED_BY(m_mutex) = Mode::Empty;
     UpdatePolicy m_update_policy = UpdatePolicy::Auto;
+    EvaluationPolicy m_evaluation_policy GUARDED_BY(m_mutex) = EvaluationPolicy::Full;
+
+    // Matches found so far when the query is evaluated lazily, and the table
+    // versions they were found at
+    QueryCursor m_lazy_cursor GUARDED_BY(m_mutex);
+    std::vector<ObjKey> m_lazy_keys GUARDED_BY(m_mutex);
+    TableVersions m_lazy_versions GUARDED_BY(m_mutex);
 
     bool update_link_collection() REQUIRES(m_mutex);
 
@@ -343,6 +361,7 @@ private:
 
     void evaluate_sort_and_distinct_on_collection() REQUIRES(m_mutex);
     void do_evaluate_query_if_needed(bool wants_notifications = true) REQUIRES(m_mutex);
+    bool evaluate_query_lazily(size_t ndx) REQUIRES(m_mutex);
 
     class IteratorWrapper {
     public:
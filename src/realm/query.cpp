@@ -26,6 +26,7 @@
 #include <realm/table_view.hpp>
 #include <realm/table_tpl.hpp>
 #include <realm/set.hpp>
+#include <realm/util/scope_exit.hpp>
 
 #include <algorithm>
 
@@ -1261,6 +1262,478 @@ Decimal128 Query::average_decimal128(ColKey column_key, size_t* resultcount) con
     return avg1;
 }
 
+namespace {
+
+struct GroupKeyHash {
+    size_t operator()(const Mixed& value) const
+    {
+        if (value.is_null())
+            return 0;
+        switch (value.get_type()) {
+            case type_Link:
+                return std::hash<int64_t>()(value.get<ObjKey>().value);
+            case type_Float:
+                // 0.0 and -0.0 compare equal
+                if (value.get_float() == 0)
+                    return 0;
+                break;
+            case type_Double:
+                if (value.get_double() == 0)
+                    return 0;
+                break;
+            default:
+                break;
+        }
+        return value.hash();
+    }
+};
+
+// Accumulates the aggregate of a single group.
+struct GroupAccumulator {
+    size_t count = 0;
+    size_t value_count = 0;
+    int64_t int_sum = 0;
+    double double_sum = 0;
+    Decimal128 decimal_sum{0};
+    Mixed min_max;
+
+    void add(GroupByOp op, const Mixed& value)
+    {
+        ++count;
+        if (op == GroupByOp::count || value.is_null())
+            return;
+        ++value_count;
+        switch (op) {
+            case GroupByOp::sum:
+            case GroupByOp::average:
+                switch (value.get_type()) {
+                    case type_Int:
+                        int_sum += value.get_int();
+                        break;
+                    case type_Float:
+                        double_sum += value.get_float();
+                        break;
+                    case type_Double:
+                        double_sum += value.get_double();
+                        break;
+                    case type_Decimal:
+                        decimal_sum += value.get<Decimal128>();
+                        break;
+                    default:
+                        REALM_UNREACHABLE();
+                }
+                break;
+            case GroupByOp::min:
+                if (value_count == 1 || value.compare(min_max) < 0)
+                    min_max = value;
+                break;
+            case GroupByOp::max:
+                if (value_count == 1 || value.compare(min_max) > 0)
+                    min_max = value;
+                break;
+            case GroupByOp::count:
+                break;
+        }
+    }
+
+    Mixed result(GroupByOp op, ColumnType type) const
+    {
+        switch (op) {
+            case GroupByOp::sum:
+                if (type == col_type_Int)
+                    return int_sum;
+                if (type == col_type_Decimal)
+                    return decimal_sum;
+                return double_sum;
+            case GroupByOp::average:
+                if (value_count == 0)
+                    return Mixed();
+                if (type == col_type_Int)
+                    return double(int_sum) / value_count;
+                if (type == col_type_Decimal)
+                    return decimal_sum / value_count;
+                return double_sum / value_count;
+            case GroupByOp::min:
+            case GroupByOp::max:
+                return min_max;
+            case GroupByOp::count:
+                break;
+        }
+        return Mixed();
+    }
+};
+
+// The types of the columns whose values objects can be grouped by
+bool is_group_by_type(ColumnType type)
+{
+    switch (type) {
+        case col_type_Int:
+        case col_type_Bool:
+        case col_type_String:
+        case col_type_Binary:
+        case col_type_Timestamp:
+        case col_type_Float:
+        case col_type_Double:
+        case col_type_Decimal:
+        case col_type_Link:
+        case col_type_ObjectId:
+        case col_type_UUID:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // anonymous namespace
+
+GroupByResult Query::group_by(ColKey group_column, GroupByOp op, ColKey aggregate_column) const
+{
+    m_table->report_invalid_key(group_column);
+    if (group_column.is_collection() || !is_group_by_type(group_column.get_type()))
+        throw LogicError(LogicError::illegal_type);
+
+    ColumnType aggregate_type = col_type_Int;
+    if (op != GroupByOp::count) {
+        m_table->report_invalid_key(aggregate_column);
+        if (aggregate_column.is_collection())
+            throw LogicError(LogicError::illegal_type);
+        aggregate_type = aggregate_column.get_type();
+        bool is_numeric = aggregate_type == col_type_Int || aggregate_type == col_type_Float ||
+                          aggregate_type == col_type_Double || aggregate_type == col_type_Decimal;
+        bool is_min_max = op == GroupByOp::min || op == GroupByOp::max;
+        if (!is_numeric && !(is_min_max && aggregate_type == col_type_Timestamp))
+            throw LogicError(LogicError::illegal_type);
+    }
+
+    init();
+
+    GroupByResult result;
+    std::unordered_map<Mixed, size_t, GroupKeyHash> group_indexes;
+    std::vector<GroupAccumulator> groups;
+
+    auto add = [&](Mixed key, const Mixed& value) {
+        auto it = group_indexes.find(key);
+        if (it == group_indexes.end()) {
+            // The key must outlive the leaf it was read from
+            if (!key.is_null() && key.get_type() == type_String) {
+                StringData str = key.get_string();
+                result.key_storage.emplace_back(str.data(), str.size());
+                key = StringData(result.key_storage.back());
+            }
+            else if (!key.is_null() && key.get_type() == type_Binary) {
+                BinaryData bin = key.get_binary();
+                result.key_storage.emplace_back(bin.data(), bin.size());
+                auto& str = result.key_storage.back();
+                key = BinaryData(str.data(), str.size());
+            }
+            it = group_indexes.emplace(key, groups.size()).first;
+            result.keys.push_back(key);
+            groups.emplace_back();
+        }
+        groups[it->second].add(op, value);
+    };
+
+    if (m_view) {
+        for (size_t t = 0; t < m_view->size(); t++) {
+            const Obj obj = m_view->get_object(t);
+            if (eval_object(obj))
+                add(obj.get_any(group_column), op == GroupByOp::count ? Mixed() : obj.get_any(aggregate_column));
+        }
+    }
+    else {
+        // Find the matching objects of each cluster through the query nodes,
+        // and read the group keys and values from the leaves of the cluster.
+        Allocator& alloc = m_table->get_alloc();
+        auto group_leaf = TwoColumnsNodeBase::update_cached_leaf_pointers_for_column(alloc, group_column);
+        std::unique_ptr<ArrayPayload> aggregate_leaf;
+        if (op != GroupByOp::count)
+            aggregate_leaf = TwoColumnsNodeBase::update_cached_leaf_pointers_for_column(alloc, aggregate_column);
+
+        IntegerColumn matches(Allocator::get_default());
+        matches.create();
+        auto destroy_matches = util::make_scope_exit([&]() noexcept {
+            matches.destroy();
+        });
+        ParentNode* node = has_conditions() ? root_node() : nullptr;
+        if (node) {
+            for (size_t c = 0; c < node->m_children.size(); c++)
+                node->m_children[c]->aggregate_local_prepare(act_FindAll, type_Int, false);
+        }
+
+        auto f = [&](const Cluster* cluster) {
+            size_t e = cluster->node_size();
+            cluster->init_leaf(group_column, group_leaf.get());
+            if (aggregate_leaf)
+                cluster->init_leaf(aggregate_column, aggregate_leaf.get());
+            auto add_match = [&](size_t i) {
+                add(group_leaf->get_any(i), aggregate_leaf ? aggregate_leaf->get_any(i) : Mixed());
+            };
+            if (node) {
+                matches.clear();
+                QueryState<int64_t> st(act_FindAll, &matches);
+                node->set_cluster(cluster);
+                aggregate_internal(node, &st, 0, e, nullptr);
+                for (size_t i = 0; i < matches.size(); ++i)
+                    add_match(size_t(matches.get(i)));
+            }
+            else {
+                for (size_t i = 0; i < e; ++i)
+                    add_match(i);
+            }
+            // Continue
+            return false;
+        };
+
+        m_table->traverse_clusters(f);
+    }
+
+    result.counts.reserve(groups.size());
+    for (auto& group : groups)
+        result.counts.push_back(group.count);
+    if (op != GroupByOp::count) {
+        result.values.reserve(groups.size());
+        for (auto& group : groups)
+            result.values.push_back(group.result(op, aggregate_type));
+    }
+    return result;
+}
+
+void MaterializedAggregate::Partial::add(const Mixed& value)
+{
+    ++count;
+    if (value.is_null())
+        return;
+    switch (value.get_type()) {
+        case type_Int:
+            int_sum += value.get_int();
+            break;
+        case type_Float:
+            double_sum += value.get_float();
+            break;
+        case type_Double:
+            double_sum += value.get_double();
+            break;
+        case type_Decimal:
+            decimal_sum += value.get<Decimal128>();
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+    if (value_count == 0 || value.compare(min) < 0)
+        min = value;
+    if (value_count == 0 || value.compare(max) > 0)
+        max = value;
+    ++value_count;
+}
+
+void MaterializedAggregate::Partial::add(const Partial& other)
+{
+    if (other.value_count > 0) {
+        if (value_count == 0 || other.min.compare(min) < 0)
+            min = other.min;
+        if (value_count == 0 || other.max.compare(max) > 0)
+            max = other.max;
+    }
+    count += other.count;
+    value_count += other.value_count;
+    int_sum += other.int_sum;
+    double_sum += other.double_sum;
+    decimal_sum += other.decimal_sum;
+}
+
+MaterializedAggregate::MaterializedAggregate(Query query, ColKey column)
+    : m_query(std::move(query))
+    , m_column(column)
+{
+    if (m_column) {
+        get_table().report_invalid_key(m_column);
+        ColumnType type = m_column.get_type();
+        bool is_numeric =
+            type == col_type_Int || type == col_type_Float || type == col_type_Double || type == col_type_Decimal;
+        if (m_column.is_collection() || !is_numeric)
+            throw LogicError(LogicError::illegal_type);
+    }
+}
+
+const Table& MaterializedAggregate::get_table() const
+{
+    if (!m_query.m_table)
+        throw LogicError(LogicError::detached_accessor);
+    return *m_query.m_table;
+}
+
+void MaterializedAggregate::check_column() const
+{
+    if (!m_column)
+        throw LogicError(LogicError::column_does_not_exist);
+}
+
+size_t MaterializedAggregate::count() const
+{
+    refresh();
+    return m_total.count;
+}
+
+Mixed MaterializedAggregate::sum() const
+{
+    check_column();
+    refresh();
+    switch (m_column.get_type()) {
+        case col_type_Int:
+            return m_total.int_sum;
+        case col_type_Decimal:
+            return m_total.decimal_sum;
+        default:
+            return m_total.double_sum;
+    }
+}
+
+Mixed MaterializedAggregate::min() const
+{
+    check_column();
+    refresh();
+    return m_total.min;
+}
+
+Mixed MaterializedAggregate::max() const
+{
+    check_column();
+    refresh();
+    return m_total.max;
+}
+
+Mixed MaterializedAggregate::average() const
+{
+    check_column();
+    refresh();
+    if (m_total.value_count == 0)
+        return Mixed();
+    switch (m_column.get_type()) {
+        case col_type_Int:
+            return double(m_total.int_sum) / m_total.value_count;
+        case col_type_Decimal:
+            return m_total.decimal_sum / m_total.value_count;
+        default:
+            return m_total.double_sum / m_total.value_count;
+    }
+}
+
+void MaterializedAggregate::refresh() const
+{
+    const Table& table = get_table();
+    if (m_column)
+        table.report_invalid_key(m_column);
+
+    // Rolling back a write transaction restores the table versions seen
+    // before it, so results computed while writing must not be cached
+    auto transaction = dynamic_cast<Transaction*>(table.get_parent_group());
+    bool writing = transaction && transaction->get_transact_stage() == DB::transact_Writing;
+
+    TableVersions versions = m_query.sync_view_if_needed();
+    if (m_valid && versions == m_versions) {
+        // The clusters are unchanged, so the partials are valid in the
+        // current version too. Move the pin there, so that the old version
+        // can be released.
+        if (m_pinned_transaction && !writing &&
+            m_pinned_transaction->get_version_of_current_transaction() !=
+                transaction->get_version_of_current_transaction())
+            m_pinned_transaction = transaction->duplicate();
+        return;
+    }
+
+    m_query.init();
+    Partial total;
+    if (m_query.m_view) {
+        for (size_t t = 0; t < m_query.m_view->size(); t++) {
+            const Obj obj = m_query.m_view->get_object(t);
+            if (m_query.eval_object(obj))
+                total.add(m_column ? obj.get_any(m_column) : Mixed());
+        }
+    }
+    else {
+        // Whatever matches in a cluster only depends on the cluster itself
+        // if the query does not follow any links, not even back into the
+        // same table
+        std::vector<TableKey> link_dependencies;
+        if (ParentNode* root = m_query.root_node())
+            root->get_link_dependencies(link_dependencies);
+        bool single_table = link_dependencies.empty();
+        bool reuse = single_table && m_pinned_transaction;
+        bool memoize = single_table && transaction && !writing;
+
+        std::unique_ptr<ArrayPayload> leaf;
+        if (m_column)
+            leaf = TwoColumnsNodeBase::update_cached_leaf_pointers_for_column(table.get_alloc(), m_column);
+
+        IntegerColumn matches(Allocator::get_default());
+        matches.create();
+        auto destroy_matches = util::make_scope_exit([&]() noexcept {
+            matches.destroy();
+        });
+        ParentNode* node = m_query.has_conditions() ? m_query.root_node() : nullptr;
+        if (node) {
+            for (size_t c = 0; c < node->m_children.size(); c++)
+                node->m_children[c]->aggregate_local_prepare(act_FindAll, type_Int, false);
+        }
+
+        std::unordered_map<ref_type, Partial> partials;
+        auto f = [&](const Cluster* cluster) {
+            // A cluster that is not writeable is unchanged as long as its ref is
+            // alive, which the pinned transaction guarantees
+            ref_type ref = cluster->get_ref();
+            bool read_only = !cluster->is_writeable();
+            if (reuse && read_only) {
+                auto it = m_cluster_partials.find(ref);
+                if (it != m_cluster_partials.end()) {
+                    total.add(it->second);
+                    if (memoize)
+                        partials.insert(*it);
+                    return false;
+                }
+            }
+
+            Partial partial;
+            size_t e = cluster->node_size();
+            if (leaf)
+                cluster->init_leaf(m_column, leaf.get());
+            auto add_match = [&](size_t i) {
+                partial.add(leaf ? leaf->get_any(i) : Mixed());
+            };
+            if (node) {
+                matches.clear();
+                QueryState<int64_t> st(act_FindAll, &matches);
+                node->set_cluster(cluster);
+                m_query.aggregate_internal(node, &st, 0, e, nullptr);
+                for (size_t i = 0; i < matches.size(); ++i)
+                    add_match(size_t(matches.get(i)));
+            }
+            else {
+                for (size_t i = 0; i < e; ++i)
+                    add_match(i);
+            }
+            total.add(partial);
+            if (memoize && read_only)
+                partials.emplace(ref, partial);
+            // Continue
+            return false;
+        };
+        table.traverse_clusters(f);
+
+        if (memoize) {
+            m_pinned_transaction = transaction->duplicate();
+            m_cluster_partials = std::move(partials);
+        }
+        else if (!reuse) {
+            m_pinned_transaction.reset();
+            m_cluster_partials.clear();
+        }
+    }
+
+    m_total = total;
+    m_versions = std::move(versions);
+    m_valid = !writing;
+}
+
 
 // Grouping
 Query& Query::group()
@@ -1482,6 +1955,47 @@ void Query::find_all(ConstTableView& ret, size_t begin, size_t end, size_t limit
     }
 }
 
+ObjKey Query::find_next(ObjKey begin, size_t limit, std::vector<ObjKey>& keys) const
+{
+    REALM_ASSERT(produces_results_in_table_order());
+    if (!m_table)
+        return ObjKey();
+    if (limit == 0)
+        return begin;
+
+    init();
+
+    ParentNode* node = has_conditions() ? root_node() : nullptr;
+    auto& clusters = m_table.unchecked_ptr()->m_clusters;
+    Cluster leaf(0, clusters.get_alloc(), clusters);
+    ClusterNode::IteratorState state(leaf);
+
+    // Each iteration picks up the search in the cluster holding the first key not yet examined
+    while (clusters.get_leaf(begin, state)) {
+        size_t end = leaf.node_size();
+        size_t ndx = state.m_current_index;
+        if (node)
+            node->set_cluster(&leaf);
+        while (ndx < end) {
+            size_t m = node ? node->find_first(ndx, end) : ndx;
+            if (m == not_found) {
+                ndx = end;
+                break;
+            }
+            keys.push_back(leaf.get_real_key(m));
+            ndx = m + 1;
+            if (--limit == 0)
+                break;
+        }
+        if (ndx < end)
+            return leaf.get_real_key(ndx);
+        begin = ObjKey(leaf.get_real_key(end - 1).value + 1);
+        if (limit == 0)
+            return begin;
+    }
+    return ObjKey();
+}
+
 TableView Query::find_all(size_t start, size_t end, size_t limit)
 {
 #if REALM_METRICS
@@ -23,7 +23,9 @@
 #include <cstdio>
 #include <climits>
 #include <algorithm>
+#include <deque>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #define REALM_MULTITHREAD_QUERY 0
@@ -58,6 +60,40 @@ namespace metrics {
 class QueryInfo;
 }
 
+/// The aggregate computed per group by Query::group_by().
+enum class GroupByOp { count, sum, min, max, average };
+
+/// The result of Query::group_by(), in columnar form. Row `i` describes the
+/// group of objects whose grouping column has the value `keys[i]`. Groups
+/// appear in the order in which they were first encountered.
+struct GroupByResult {
+    GroupByResult() = default;
+    // The keys refer to key_storage, so a copy would refer to the storage of
+    // the original
+    GroupByResult(const GroupByResult&) = delete;
+    GroupByResult& operator=(const GroupByResult&) = delete;
+    GroupByResult(GroupByResult&&) = default;
+    GroupByResult& operator=(GroupByResult&&) = default;
+
+    /// The value of the grouping column for each group. String and binary
+    /// values refer to memory owned by this result.
+    std::vector<Mixed> keys;
+    /// The number of objects in each group.
+    std::vector<size_t> counts;
+    /// The aggregate of each group, computed over the non-null values of the
+    /// aggregated column. The minimum, maximum and average of a group without
+    /// any such values is null. Empty if the operation is GroupByOp::count.
+    std::vector<Mixed> values;
+
+    size_t size() const noexcept
+    {
+        return keys.size();
+    }
+
+    /// Storage for string and binary keys.
+    std::deque<std::string> key_storage;
+};
+
 struct QueryGroup {
     enum class State {
         Default,
@@ -250,6 +286,13 @@ public:
     ObjKey find();
     TableView find_all(size_t start = 0, size_t end = size_t(-1), size_t limit = size_t(-1));
 
+    /// Appends at most \a limit matching objects with a key not less than \a
+    /// begin to \a keys, in table order. Returns the key to pass as \a begin
+    /// to continue the search after the last match, or a null key if the end
+    /// of the table was reached. The query must produce its results in table
+    /// order. See also QueryCursor.
+    ObjKey find_next(ObjKey begin, size_t limit, std::vector<ObjKey>& keys) const;
+
     // Aggregates
     size_t count() const;
     TableView find_all(const DescriptorOrdering& descriptor);
@@ -273,6 +316,15 @@ public:
     Decimal128 minimum_decimal128(ColKey column_key, ObjKey* return_ndx = nullptr) const;
     Decimal128 average_decimal128(ColKey column_key, size_t* resultcount = nullptr) const;
 
+    /// Groups the matching objects by the value of \a group_column, which must
+    /// be a non-collection column of any type other than Mixed, and counts the
+    /// objects in each group. Unless \a op is GroupByOp::count, the values of
+    /// \a aggregate_column are aggregated per group as well. Sum and average
+    /// are supported for integer, float, double and decimal columns, and
+    /// minimum and maximum for those and timestamp columns.
+    GroupByResult group_by(ColKey group_column, GroupByOp op = GroupByOp::count,
+                           ColKey aggregate_column = ColKey()) const;
+
     // Deletion
     size_t remove();
 
@@ -371,6 +423,7 @@ private:
     friend class SubQueryCount;
     friend class PrimitiveListCount;
     friend class metrics::QueryInfo;
+    friend class MaterializedAggregate;
 
     std::string error_code;
 
@@ -392,6 +445,115 @@ private:
     std::shared_ptr<DescriptorOrdering> m_ordering;
 };
 
+/// A QueryCursor produces the matches of a query a few at a time, in table
+/// order, instead of materializing all of them in a TableView up front. The
+/// position is kept as the key of the next object to examine, so the cursor
+/// can be advanced again after the table has been modified; objects inserted
+/// before the position are then not visited. The query must produce its
+/// results in table order.
+class QueryCursor {
+public:
+    QueryCursor() = default;
+    explicit QueryCursor(Query query)
+        : m_query(std::move(query))
+    {
+    }
+
+    /// Appends up to \a max_count further matches to \a keys and returns the
+    /// number of keys appended. Fewer than \a max_count are appended only when
+    /// the end of the table is reached.
+    size_t next(size_t max_count, std::vector<ObjKey>& keys)
+    {
+        size_t old_size = keys.size();
+        if (m_position && max_count > 0)
+            m_position = m_query.find_next(m_position, max_count, keys);
+        return keys.size() - old_size;
+    }
+
+    bool at_end() const noexcept
+    {
+        return !m_position;
+    }
+
+    /// Start over from the beginning of the table.
+    void reset() noexcept
+    {
+        m_position = ObjKey(0);
+    }
+
+private:
+    Query m_query;
+    ObjKey m_position = ObjKey(0);
+};
+
+/// A MaterializedAggregate keeps the number of objects matching a query, and
+/// the sum, minimum, maximum and average of a column over them. Reading the
+/// aggregates again when none of the tables the query depends on has changed
+/// does not run the query. When the table has changed, the partial aggregates
+/// of the clusters of objects that were not modified are reused, so only the
+/// modified clusters are searched again.
+///
+/// Partial aggregates are only reused for queries that do not follow links
+/// or backlinks and are not restricted by a view, over a table accessed
+/// through a read or frozen transaction. The aggregates are kept in memory
+/// only.
+///
+/// While partial aggregates are kept, the version they were computed at is
+/// pinned as if by an open read transaction, so the space released by later
+/// versions is not reused and the file can grow. The pin is moved to the
+/// current version whenever the aggregates are read or refreshed, and the
+/// partials of older versions are dropped. Destroy an aggregate which is no
+/// longer read.
+class MaterializedAggregate {
+public:
+    /// \a column must be an integer, float, double or decimal column. If it is
+    /// null, only count() is available.
+    explicit MaterializedAggregate(Query query, ColKey column = ColKey());
+
+    size_t count() const;
+    /// An integer for integer columns, a Decimal128 for decimal columns and a
+    /// double otherwise.
+    Mixed sum() const;
+    /// The minimum, maximum and average of the non-null values of the column,
+    /// or null if there are none.
+    Mixed min() const;
+    Mixed max() const;
+    Mixed average() const;
+
+    /// Brings the aggregates up to date with the current version of the
+    /// tables. Called by the accessors above.
+    void refresh() const;
+
+private:
+    struct Partial {
+        size_t count = 0;
+        size_t value_count = 0;
+        int64_t int_sum = 0;
+        double double_sum = 0;
+        Decimal128 decimal_sum{0};
+        Mixed min;
+        Mixed max;
+
+        void add(const Mixed& value);
+        void add(const Partial& other);
+    };
+
+    Query m_query;
+    ColKey m_column;
+    mutable bool m_valid = false;
+    mutable TableVersions m_versions;
+    mutable Partial m_total;
+    // The partial aggregates of unmodified clusters by ref. These can only be
+    // reused while the version they were computed at is pinned by
+    // m_pinned_transaction, as the space of a cluster released by a later
+    // version is not reused before then.
+    mutable std::unordered_map<ref_type, Partial> m_cluster_partials;
+    mutable std::shared_ptr<Transaction> m_pinned_transaction;
+
+    const Table& get_table() const;
+    void check_column() const;
+};
+
 // Implementation:
 
 inline Query& Query::equal(ColKey column_key, const char* c_str, bool case_sensitive)
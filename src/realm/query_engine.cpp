@@ -561,7 +561,23 @@ size_t size_of_list_from_ref(ref_type ref, Allocator& alloc, ColumnType col_type
 
 size_t NotNode::find_first_local(size_t start, size_t end)
 {
-    if (start <= m_known_range_start && end >= m_known_range_end) {
+    if (start >= end) {
+        return not_found;
+    }
+    else if (m_bitmap.covers(start, end)) {
+        return m_bitmap.find_first(start, end);
+    }
+    else if (end - start > 1 && m_children.size() == 1) {
+        // Let the condition skip ahead to its own matches (using a search index if it has one) and negate them all
+        // in one go rather than testing the condition one row at a time. This is not done when ANDed with other
+        // conditions, as they probe this node from each of their matches up to the end of the range, and only the
+        // rows up to the first match after the probe need to be tested.
+        m_bitmap.reset(start, end);
+        m_condition->find_all(start, end, m_bitmap);
+        m_bitmap.invert();
+        return m_bitmap.find_first(start, end);
+    }
+    else if (start <= m_known_range_start && end >= m_known_range_end) {
         return find_first_covers_known(start, end);
     }
     else if (start >= m_known_range_start && end <= m_known_range_end) {
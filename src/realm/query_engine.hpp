@@ -141,6 +141,75 @@ const size_t bitwidth_time_unit = 64;
 typedef bool (*CallbackDummy)(int64_t);
 using Evaluator = util::FunctionRef<bool(const Obj& obj)>;
 
+// Matches within a row range [begin, end) of the current cluster, one bit per row packed in 64-row words. Used by
+// OrNode and NotNode to combine the matches of their conditions with bitwise operations instead of tracking a
+// "next match" position per condition.
+class MatchBitmap {
+public:
+    void reset(size_t begin, size_t end)
+    {
+        m_begin = begin;
+        m_end = end;
+        m_words.assign((end - begin + 63) / 64, 0);
+    }
+
+    bool covers(size_t begin, size_t end) const
+    {
+        return m_begin <= begin && end <= m_end;
+    }
+
+    void set(size_t row)
+    {
+        REALM_ASSERT_DEBUG(row >= m_begin && row < m_end);
+        size_t bit = row - m_begin;
+        m_words[bit >> 6] |= uint64_t(1) << (bit & 63);
+    }
+
+    void invert()
+    {
+        for (auto& w : m_words)
+            w = ~w;
+        if (size_t tail = (m_end - m_begin) & 63)
+            m_words.back() &= (uint64_t(1) << tail) - 1;
+    }
+
+    // Returns the first matching row in [begin, end), or not_found.
+    size_t find_first(size_t begin, size_t end) const
+    {
+        REALM_ASSERT_DEBUG(covers(begin, end));
+        if (begin >= end)
+            return not_found;
+        size_t bit = begin - m_begin;
+        size_t end_bit = end - m_begin;
+        size_t w = bit >> 6;
+        uint64_t word = m_words[w] & (~uint64_t(0) << (bit & 63));
+        for (;;) {
+            if (word) {
+                size_t found = (w << 6) + first_bit(word);
+                return found < end_bit ? m_begin + found : not_found;
+            }
+            if (++w >= m_words.size() || (w << 6) >= end_bit)
+                return not_found;
+            word = m_words[w];
+        }
+    }
+
+private:
+    size_t m_begin = 0;
+    size_t m_end = 0;
+    std::vector<uint64_t> m_words;
+
+    static size_t first_bit(uint64_t word)
+    {
+#ifdef REALM_PTR_64
+        return ctz(size_t(word));
+#else
+        auto low = size_t(uint32_t(word));
+        return low ? ctz(low) : 32 + ctz(size_t(word >> 32));
+#endif
+    }
+};
+
 class ParentNode {
     typedef ParentNode ThisType;
 
@@ -176,6 +245,14 @@ public:
 
     size_t find_first(size_t start, size_t end);
 
+    // Sets the bits of all rows in [start, end) that match this node and the conditions ANDed to it. Bits that are
+    // already set are left alone, so filling the same bitmap from several nodes ORs their matches together.
+    void find_all(size_t start, size_t end, MatchBitmap& bitmap)
+    {
+        for (size_t m = find_first(start, end); m != not_found; m = find_first(m + 1, end))
+            bitmap.set(m);
+    }
+
     bool match(const Obj& obj);
 
     virtual void init(bool will_query_ranges)
@@ -2191,6 +2268,8 @@ public:
 
         m_was_match.clear();
         m_was_match.resize(m_conditions.size(), false);
+
+        m_bitmap.reset(0, 0);
     }
 
     std::string describe(util::serializer::SerialisationState& state) const override
@@ -2237,6 +2316,12 @@ public:
             v.clear();
             condition->gather_children(v);
         }
+
+        // For wide disjunctions, tracking the next match of every condition costs a pass over all conditions per
+        // match found. Instead let each condition mark its matches in a bitmap covering the searched range, and
+        // serve the following searches in that range from the bitmap.
+        m_use_bitmap = m_conditions.size() >= s_bitmap_min_conditions;
+        m_bitmap.reset(0, 0);
     }
 
     size_t find_first_local(size_t start, size_t end) override
@@ -2244,6 +2329,18 @@ public:
         if (start >= end)
             return not_found;
 
+        if (m_bitmap.covers(start, end))
+            return m_bitmap.find_first(start, end);
+
+        // Single row probes from other conditions are cheaper to answer directly. So are the probes from the
+        // matches of conditions ANDed to this node, which only need the conditions tested up to their next match.
+        if (m_use_bitmap && end - start > 1 && m_children.size() == 1) {
+            m_bitmap.reset(start, end);
+            for (auto& condition : m_conditions)
+                condition->find_all(start, end, m_bitmap);
+            return m_bitmap.find_first(start, end);
+        }
+
         size_t index = not_found;
 
         for (size_t c = 0; c < m_conditions.size(); ++c) {
@@ -2319,12 +2416,17 @@ private:
         m_conditions.erase(std::remove_if(m_conditions.begin() + 1, m_conditions.end(), cond), m_conditions.end());
     }
 
+    static constexpr size_t s_bitmap_min_conditions = 3;
+
     // start index of the last find for each cond
     std::vector<size_t> m_start;
     // last looked at index of the lasft find for each cond
     // is a matching index if m_was_match is true
     std::vector<size_t> m_last;
     std::vector<bool> m_was_match;
+    // matches of all conds in the range last searched, when m_use_bitmap is true
+    MatchBitmap m_bitmap;
+    bool m_use_bitmap = false;
 };
 
 
@@ -2348,6 +2450,7 @@ public:
         m_known_range_start = 0;
         m_known_range_end = 0;
         m_first_in_known_range = not_found;
+        m_bitmap.reset(0, 0);
     }
 
     void init(bool will_query_ranges) override
@@ -2416,6 +2519,8 @@ private:
     size_t m_known_range_start;
     size_t m_known_range_end;
     size_t m_first_in_known_range;
+    // complement of the matches of m_condition in the range last searched
+    MatchBitmap m_bitmap;
 
     bool evaluate_at(size_t rowndx);
     void update_known(size_t start, size_t end, size_t first);
@@ -19,6 +19,7 @@
 #include <realm/query_expression.hpp>
 #include <realm/group.hpp>
 #include <realm/dictionary.hpp>
+#include <realm/table_view.hpp>
 
 namespace realm {
 
@@ -51,8 +52,9 @@ void LinkMap::set_base_table(ConstTableRef table)
 
 void LinkMap::collect_dependencies(std::vector<TableKey>& tables) const
 {
-    for (auto& t : m_tables) {
-        TableKey k = t->get_key();
+    // The first table is the base table, which is not reached through a link
+    for (size_t i = 1; i < m_tables.size(); ++i) {
+        TableKey k = m_tables[i]->get_key();
         if (find(tables.begin(), tables.end(), k) == tables.end()) {
             tables.push_back(k);
         }
@@ -222,6 +224,27 @@ std::vector<ObjKey> LinkMap::get_origin_ndxs(ObjKey key, size_t column) const
     return ret;
 }
 
+bool LinkMap::get_origin_keys(Query& target_query, size_t max_target_matches,
+                              std::vector<ObjKey>& origin_keys) const
+{
+    // The query will report removed link columns when it is evaluated the ordinary way
+    for (size_t i = 0; i < m_link_column_keys.size(); i++) {
+        if (!m_tables[i]->valid_column(m_link_column_keys[i]))
+            return false;
+    }
+
+    TableView target_objects = target_query.find_all(0, size_t(-1), max_target_matches + 1);
+    size_t sz = target_objects.size();
+    if (sz > max_target_matches)
+        return false;
+
+    for (size_t i = 0; i < sz; i++) {
+        auto keys = get_origin_ndxs(target_objects.get_key(i));
+        origin_keys.insert(origin_keys.end(), keys.begin(), keys.end());
+    }
+    return true;
+}
+
 ColumnDictionaryKey Columns<Dictionary>::key(const Mixed& key_value)
 {
     if (m_key_type != type_Mixed && key_value.get_type() != m_key_type) {
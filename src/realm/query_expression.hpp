@@ -277,6 +277,7 @@ public:
     using ValueType = QueryValue;
 
     static const size_t chunk_size = 8;
+    static constexpr size_t batch_size = 256;
     bool m_from_link_list = false;
 
     ValueBase() = default;
@@ -687,8 +688,40 @@ public:
     {
         return ExpressionComparisonType::Any;
     }
+
+    // Numeric expressions that do not follow links can be evaluated for up to
+    // ValueBase::batch_size rows of the current cluster at a time, into plain
+    // arrays of int64_t (type_Int) or double (type_Double) values. 'nulls' is
+    // set for the rows where the expression is null. This avoids the boxing of
+    // each value and the virtual calls per chunk of evaluate().
+    virtual bool has_batch_evaluation(DataType) const
+    {
+        return false;
+    }
+    virtual void evaluate_int_batch(size_t, size_t, int64_t*, bool*)
+    {
+        REALM_UNREACHABLE();
+    }
+    virtual void evaluate_double_batch(size_t, size_t, double*, bool*)
+    {
+        REALM_UNREACHABLE();
+    }
 };
 
+// Evaluates 'expr' as double values, converting from integers if needed
+inline void evaluate_batch_as_double(Subexpr& expr, size_t index, size_t count, double* values, bool* nulls)
+{
+    if (expr.has_batch_evaluation(type_Double)) {
+        expr.evaluate_double_batch(index, count, values, nulls);
+    }
+    else {
+        int64_t int_values[ValueBase::batch_size];
+        expr.evaluate_int_batch(index, count, int_values, nulls);
+        for (size_t i = 0; i < count; i++)
+            values[i] = double(int_values[i]);
+    }
+}
+
 template <typename T, typename... Args>
 std::unique_ptr<Subexpr> make_subexpr(Args&&... args)
 {
@@ -1181,6 +1214,38 @@ public:
         destination = *this;
     }
 
+    bool has_batch_evaluation(DataType type) const override
+    {
+        if (ValueBase::m_from_link_list || size() != 1)
+            return false;
+        auto val = get(0);
+        if (val.is_null())
+            return type == type_Int || type == type_Double;
+        switch (val.get_type()) {
+            case type_Int:
+                return type == type_Int;
+            case type_Float:
+            case type_Double:
+                return type == type_Double;
+            default:
+                return false;
+        }
+    }
+
+    void evaluate_int_batch(size_t, size_t count, int64_t* values, bool* nulls) override
+    {
+        auto val = get(0);
+        std::fill(values, values + count, val.is_null() ? 0 : val.get_int());
+        std::fill(nulls, nulls + count, val.is_null());
+    }
+
+    void evaluate_double_batch(size_t, size_t count, double* values, bool* nulls) override
+    {
+        auto val = get(0);
+        std::fill(values, values + count, val.is_null() ? 0 : val.template export_to_type<double>());
+        std::fill(nulls, nulls + count, val.is_null());
+    }
+
     std::unique_ptr<Subexpr> clone() const override
     {
         return make_subexpr<Value<T>>(*this);
@@ -1746,6 +1811,11 @@ public:
 
     std::vector<ObjKey> get_origin_ndxs(ObjKey key, size_t column = 0) const;
 
+    // Collects the keys of the base table objects linking to the objects in
+    // the target table matched by 'target_query'. Returns false without
+    // collecting anything if more than 'max_target_matches' objects match.
+    bool get_origin_keys(Query& target_query, size_t max_target_matches, std::vector<ObjKey>& origin_keys) const;
+
     size_t count_links(size_t row) const
     {
         CountLinks counter;
@@ -3699,6 +3769,59 @@ public:
         }
     }
 
+    bool has_batch_evaluation(DataType type) const override
+    {
+        if (links_exist())
+            return false;
+        if constexpr (std::is_same_v<T, Int>)
+            return type == type_Int;
+        if constexpr (std::is_same_v<T, Float> || std::is_same_v<T, Double>)
+            return type == type_Double;
+        return false;
+    }
+
+    void evaluate_int_batch(size_t index, size_t count, int64_t* values, bool* nulls) override
+    {
+        if constexpr (std::is_same_v<T, Int>) {
+            REALM_ASSERT(m_leaf_ptr != nullptr);
+            if (is_nullable()) {
+                auto leaf = static_cast<const ArrayIntNull*>(m_leaf_ptr);
+                for (size_t i = 0; i < count; i++) {
+                    auto val = leaf->get(index + i);
+                    nulls[i] = !val;
+                    values[i] = val ? *val : 0;
+                }
+            }
+            else {
+                auto leaf = static_cast<const Array*>(static_cast<const ArrayInteger*>(m_leaf_ptr));
+                size_t i = 0;
+                for (; i + ValueBase::chunk_size <= count; i += ValueBase::chunk_size)
+                    leaf->get_chunk(index + i, values + i);
+                for (; i < count; i++)
+                    values[i] = leaf->get(index + i);
+                std::fill(nulls, nulls + count, false);
+            }
+        }
+        else {
+            REALM_UNREACHABLE();
+        }
+    }
+
+    void evaluate_double_batch(size_t index, size_t count, double* values, bool* nulls) override
+    {
+        if constexpr (std::is_same_v<T, Float> || std::is_same_v<T, Double>) {
+            REALM_ASSERT(m_leaf_ptr != nullptr);
+            auto leaf = static_cast<const LeafType*>(m_leaf_ptr);
+            for (size_t i = 0; i < count; i++) {
+                nulls[i] = leaf->is_null(index + i);
+                values[i] = leaf->get(index + i);
+            }
+        }
+        else {
+            REALM_UNREACHABLE();
+        }
+    }
+
     void evaluate(ObjKey key, ValueBase& destination) override
     {
         destination.init(false, 1);
@@ -4271,6 +4394,59 @@ public:
         destination = result;
     }
 
+    bool has_batch_evaluation(DataType type) const override
+    {
+        if constexpr (std::is_same_v<T, int64_t>) {
+            // Integer division by zero must not be evaluated ahead of the rows
+            // asked for
+            return type == type_Int && !std::is_same_v<oper, Div<T>> && m_left->has_batch_evaluation(type_Int) &&
+                   m_right->has_batch_evaluation(type_Int);
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            auto has_operand = [](const Subexpr& expr) {
+                return expr.has_batch_evaluation(type_Double) || expr.has_batch_evaluation(type_Int);
+            };
+            return type == type_Double && has_operand(*m_left) && has_operand(*m_right);
+        }
+        return false;
+    }
+
+    void evaluate_int_batch(size_t index, size_t count, int64_t* values, bool* nulls) override
+    {
+        if constexpr (std::is_same_v<T, int64_t>) {
+            int64_t right[ValueBase::batch_size];
+            bool right_nulls[ValueBase::batch_size];
+            m_left->evaluate_int_batch(index, count, values, nulls);
+            m_right->evaluate_int_batch(index, count, right, right_nulls);
+            oper o;
+            for (size_t i = 0; i < count; i++) {
+                nulls[i] |= right_nulls[i];
+                values[i] = nulls[i] ? 0 : o(values[i], right[i]);
+            }
+        }
+        else {
+            REALM_UNREACHABLE();
+        }
+    }
+
+    void evaluate_double_batch(size_t index, size_t count, double* values, bool* nulls) override
+    {
+        if constexpr (std::is_same_v<T, double>) {
+            double right[ValueBase::batch_size];
+            bool right_nulls[ValueBase::batch_size];
+            evaluate_batch_as_double(*m_left, index, count, values, nulls);
+            evaluate_batch_as_double(*m_right, index, count, right, right_nulls);
+            oper o;
+            for (size_t i = 0; i < count; i++) {
+                nulls[i] |= right_nulls[i];
+                values[i] = o(values[i], right[i]);
+            }
+        }
+        else {
+            REALM_UNREACHABLE();
+        }
+    }
+
     virtual std::string description(util::serializer::SerialisationState& state) const override
     {
         std::string s;
@@ -4323,36 +4499,59 @@ public:
         else {
             m_left->set_cluster(cluster);
             m_right->set_cluster(cluster);
+            m_batch_begin = m_batch_end = 0;
         }
     }
 
     double init() override
     {
         double dT = m_left_is_const ? 10.0 : 50.0;
+        m_has_matches = false;
         if (std::is_same_v<TCond, Equal> && m_left_is_const && m_right->has_search_index() &&
             m_right->get_comparison_type() == ExpressionComparisonType::Any) {
             if (m_left_value.is_null()) {
                 m_matches = m_right->find_all(Mixed());
+                m_has_matches = true;
             }
-            else {
-                if (m_right->get_type() != m_left_value.get_type()) {
-                    // If the type we are looking for is not the same type as the target
-                    // column, we cannot use the index
-                    return dT;
-                }
+            else if (m_right->get_type() == m_left_value.get_type()) {
+                // If the type we are looking for is not the same type as the target
+                // column, we cannot use the index
                 m_matches = m_right->find_all(m_left_value);
+                m_has_matches = true;
             }
-            // Sort
-            std::sort(m_matches.begin(), m_matches.end());
-            // Remove all duplicates
-            m_matches.erase(std::unique(m_matches.begin(), m_matches.end()), m_matches.end());
+            if (m_has_matches) {
+                // Sort
+                std::sort(m_matches.begin(), m_matches.end());
+                // Remove all duplicates
+                m_matches.erase(std::unique(m_matches.begin(), m_matches.end()), m_matches.end());
+            }
+        }
+        else if (m_left_is_const) {
+            m_has_matches = find_matches_through_backlinks();
+        }
 
-            m_has_matches = true;
+        if (m_has_matches) {
             m_index_get = 0;
             m_index_end = m_matches.size();
             dT = 0;
         }
 
+        m_left_batch_type = m_right_batch_type = type_Mixed;
+        m_batch_begin = m_batch_end = 0;
+        if constexpr (realm::is_any_v<TCond, Equal, NotEqual, Less, Greater, LessEqual, GreaterEqual>) {
+            auto batch_type = [](const Subexpr& expr) {
+                if (expr.has_batch_evaluation(type_Int))
+                    return type_Int;
+                if (expr.has_batch_evaluation(type_Double))
+                    return type_Double;
+                return type_Mixed;
+            };
+            if (!m_has_matches) {
+                m_left_batch_type = batch_type(*m_left);
+                m_right_batch_type = batch_type(*m_right);
+            }
+        }
+
         return dT;
     }
 
@@ -4416,6 +4615,19 @@ public:
             return m_cluster->lower_bound_key(ObjKey(actual_key.value - m_cluster->get_offset()));
         }
 
+        if (m_left_batch_type == type_Int) {
+            if (m_right_batch_type == type_Int)
+                return find_first_batch<int64_t, int64_t>(start, end);
+            if (m_right_batch_type == type_Double)
+                return find_first_batch<int64_t, double>(start, end);
+        }
+        else if (m_left_batch_type == type_Double) {
+            if (m_right_batch_type == type_Int)
+                return find_first_batch<double, int64_t>(start, end);
+            if (m_right_batch_type == type_Double)
+                return find_first_batch<double, double>(start, end);
+        }
+
         size_t match;
         ValueBase right;
         const ExpressionComparisonType right_cmp_type = m_right->get_comparison_type();
@@ -4468,6 +4680,195 @@ public:
     }
 
 private:
+    // A condition on a column at the end of a link path can be evaluated as a
+    // query on the target table, followed by a walk through the backlinks to
+    // the objects of the base table. This is done if the condition matches
+    // few target objects compared to the number of objects in the base table,
+    // as following the links from every base table object is expensive, and
+    // if the target objects can be found without scanning a much larger
+    // table.
+    bool find_matches_through_backlinks()
+    {
+        auto property = dynamic_cast<const ObjPropertyBase*>(m_right.get());
+        if (!property || !property->links_exist() || m_right->get_comparison_type() != ExpressionComparisonType::Any)
+            return false;
+
+        // Objects with a null link are not found through the backlinks, so
+        // the condition must not match a null value.
+        if (m_left_value.is_null() || TCond()(m_left_value, QueryValue()))
+            return false;
+
+        ColKey column_key = property->column_key();
+        if (column_key.is_collection() || DataType(column_key.get_type()) != m_left_value.get_type())
+            return false;
+
+        LinkMap link_map = property->get_link_map();
+        ConstTableRef target_table = link_map.get_target_table();
+        if (!target_table->valid_column(column_key))
+            return false;
+
+        // Without a search index to look the condition up in, every object
+        // of the target table is examined. This is only cheaper than
+        // following the links when the target table is not much larger than
+        // the base table.
+        constexpr bool is_equality = std::is_same_v<TCond, Equal> || std::is_same_v<TCond, EqualIns>;
+        bool indexed = is_equality && target_table->has_search_index(column_key);
+        size_t base_size = link_map.get_base_table()->size();
+        if (!indexed && target_table->size() / 4 > base_size)
+            return false;
+
+        Query target_query(target_table);
+        if (!add_target_condition(target_query, column_key))
+            return false;
+
+        // Following the backlinks of a target object costs about as much as
+        // following the links of a base table object
+        size_t max_target_matches = base_size / 4;
+        m_matches.clear();
+        if (!link_map.get_origin_keys(target_query, max_target_matches, m_matches))
+            return false;
+
+        std::sort(m_matches.begin(), m_matches.end());
+        m_matches.erase(std::unique(m_matches.begin(), m_matches.end()), m_matches.end());
+        return true;
+    }
+
+    static void evaluate_batch(Subexpr& expr, size_t index, size_t count, int64_t* values, bool* nulls)
+    {
+        expr.evaluate_int_batch(index, count, values, nulls);
+    }
+
+    static void evaluate_batch(Subexpr& expr, size_t index, size_t count, double* values, bool* nulls)
+    {
+        expr.evaluate_double_batch(index, count, values, nulls);
+    }
+
+    template <class T>
+    static bool is_special_batch_value(T value, bool mixed_types)
+    {
+        if constexpr (std::is_same_v<T, double>) {
+            return std::isnan(value);
+        }
+        else {
+            // Integers compared to doubles are converted exactly up to 2^53
+            constexpr int64_t max_exact = int64_t(1) << 53;
+            return mixed_types && (value > max_exact || value < -max_exact);
+        }
+    }
+
+    template <class L, class R>
+    size_t find_first_batch(size_t start, size_t end) const
+    {
+        while (start < end) {
+            // Consecutive calls usually continue right after the previous
+            // match, so reuse the batch evaluated by the previous call
+            if (start < m_batch_begin || start >= m_batch_end)
+                evaluate_batch_matches<L, R>(start, std::min(end - start, ValueBase::batch_size));
+            size_t stop = std::min(end, m_batch_end);
+            for (; start < stop; start++) {
+                if (m_batch_matches[start - m_batch_begin])
+                    return start;
+            }
+        }
+        return not_found;
+    }
+
+    template <class L, class R>
+    void evaluate_batch_matches(size_t start, size_t count) const
+    {
+        if constexpr (realm::is_any_v<TCond, Equal, NotEqual, Less, Greater, LessEqual, GreaterEqual>) {
+            constexpr bool mixed_types = !std::is_same_v<L, R>;
+            L left[ValueBase::batch_size];
+            R right[ValueBase::batch_size];
+            bool left_nulls[ValueBase::batch_size];
+            bool right_nulls[ValueBase::batch_size];
+            TCond c;
+            evaluate_batch(*m_left, start, count, left, left_nulls);
+            evaluate_batch(*m_right, start, count, right, right_nulls);
+            for (size_t i = 0; i < count; i++) {
+                bool match;
+                if (REALM_UNLIKELY(left_nulls[i] || right_nulls[i] || is_special_batch_value(left[i], mixed_types) ||
+                                   is_special_batch_value(right[i], mixed_types))) {
+                    // Nulls, NaNs and large integers compare like they do in
+                    // the unbatched evaluation
+                    QueryValue left_value = left_nulls[i] ? QueryValue() : QueryValue(left[i]);
+                    QueryValue right_value = right_nulls[i] ? QueryValue() : QueryValue(right[i]);
+                    match = c(left_value, right_value);
+                }
+                else if constexpr (mixed_types) {
+                    match = c(double(left[i]), double(right[i]));
+                }
+                else {
+                    match = c(left[i], right[i]);
+                }
+                m_batch_matches[i] = match;
+            }
+        }
+        m_batch_begin = start;
+        m_batch_end = start + count;
+    }
+
+    bool add_target_condition(Query& query, ColKey column_key) const
+    {
+        switch (m_left_value.get_type()) {
+            case type_Int:
+                return add_target_condition(query, column_key, m_left_value.get_int());
+            case type_Float:
+                return add_target_condition(query, column_key, m_left_value.get_float());
+            case type_Double:
+                return add_target_condition(query, column_key, m_left_value.get_double());
+            case type_Timestamp:
+                return add_target_condition(query, column_key, m_left_value.get_timestamp());
+            case type_ObjectId:
+                return add_target_condition(query, column_key, m_left_value.get_object_id());
+            case type_UUID:
+                return add_target_condition(query, column_key, m_left_value.get_uuid());
+            case type_String:
+                return add_target_condition(query, column_key, m_left_value.get_string());
+            default:
+                return false;
+        }
+    }
+
+    // The constant is the left operand of the condition, so the relational
+    // conditions are reversed when applied to the column (see create()).
+    template <class T>
+    static bool add_target_condition(Query& query, ColKey column_key, T value)
+    {
+        constexpr bool is_string = std::is_same_v<T, StringData>;
+        if constexpr (std::is_same_v<TCond, Equal>)
+            query.equal(column_key, value);
+        else if constexpr (std::is_same_v<TCond, Less> && !is_string)
+            query.greater(column_key, value);
+        else if constexpr (std::is_same_v<TCond, Greater> && !is_string)
+            query.less(column_key, value);
+        else if constexpr (std::is_same_v<TCond, LessEqual> && !is_string)
+            query.greater_equal(column_key, value);
+        else if constexpr (std::is_same_v<TCond, GreaterEqual> && !is_string)
+            query.less_equal(column_key, value);
+        else if constexpr (std::is_same_v<TCond, EqualIns> && is_string)
+            query.equal(column_key, value, false);
+        else if constexpr (std::is_same_v<TCond, BeginsWith> && is_string)
+            query.begins_with(column_key, value);
+        else if constexpr (std::is_same_v<TCond, BeginsWithIns> && is_string)
+            query.begins_with(column_key, value, false);
+        else if constexpr (std::is_same_v<TCond, EndsWith> && is_string)
+            query.ends_with(column_key, value);
+        else if constexpr (std::is_same_v<TCond, EndsWithIns> && is_string)
+            query.ends_with(column_key, value, false);
+        else if constexpr (std::is_same_v<TCond, Contains> && is_string)
+            query.contains(column_key, value);
+        else if constexpr (std::is_same_v<TCond, ContainsIns> && is_string)
+            query.contains(column_key, value, false);
+        else if constexpr (std::is_same_v<TCond, Like> && is_string)
+            query.like(column_key, value);
+        else if constexpr (std::is_same_v<TCond, LikeIns> && is_string)
+            query.like(column_key, value, false);
+        else
+            return false;
+        return true;
+    }
+
     Compare(const Compare& other)
         : m_left(other.m_left->clone())
         , m_right(other.m_right->clone())
@@ -4487,6 +4888,14 @@ private:
     std::vector<ObjKey> m_matches;
     mutable size_t m_index_get = 0;
     size_t m_index_end = 0;
+    // type_Int or type_Double if the operand supports batch evaluation
+    DataType m_left_batch_type = type_Mixed;
+    DataType m_right_batch_type = type_Mixed;
+    // Comparison results for the rows [m_batch_begin, m_batch_end) of the
+    // current cluster
+    mutable size_t m_batch_begin = 0;
+    mutable size_t m_batch_end = 0;
+    mutable bool m_batch_matches[ValueBase::batch_size];
 };
 } // namespace realm
 #endif // REALM_QUERY_EXPRESSION_HPP
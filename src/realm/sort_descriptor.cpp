@@ -22,6 +22,8 @@
 #include <realm/util/assert.hpp>
 #include <realm/list.hpp>
 
+#include <unordered_set>
+
 using namespace realm;
 
 LinkPathPart::LinkPathPart(ColKey col_key, ConstTableRef source)
@@ -202,6 +204,67 @@ BaseDescriptor::Sorter::Sorter(std::vector<std::vector<ColKey>> const& column_li
     }
 }
 
+namespace {
+
+size_t hash_value(const Mixed& value)
+{
+    if (value.is_null())
+        return 0;
+    if (value.get_type() == type_Link)
+        return std::hash<int64_t>()(value.get<ObjKey>().value);
+    return value.hash();
+}
+
+// Removes all but the first occurrence of each distinct combination of values
+// from \a v, preserving the order of the remaining elements. The first column
+// must have been cached by the sorter.
+void distinct_by_hash(BaseDescriptor::IndexPairs& v, const BaseDescriptor::Sorter& predicate)
+{
+    const size_t num_columns = predicate.num_columns();
+    const size_t num_extra_columns = num_columns - 1;
+
+    // Values of the columns beyond the first one
+    std::vector<Mixed> extra_values;
+    extra_values.reserve(v.size() * num_extra_columns);
+    for (auto& index : v) {
+        for (size_t t = 1; t < num_columns; ++t)
+            extra_values.push_back(predicate.get_value(t, index));
+    }
+    auto get_value = [&](size_t i, size_t t) -> const Mixed& {
+        return t == 0 ? v[i].cached_value : extra_values[i * num_extra_columns + t - 1];
+    };
+
+    auto hash = [&](size_t i) {
+        size_t h = hash_value(get_value(i, 0));
+        for (size_t t = 1; t < num_columns; ++t)
+            h ^= hash_value(get_value(i, t)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    };
+    auto equal = [&](size_t i, size_t j) {
+        for (size_t t = 0; t < num_columns; ++t) {
+            if (get_value(i, t).compare(get_value(j, t)) != 0)
+                return false;
+        }
+        return true;
+    };
+
+    std::unordered_set<size_t, decltype(hash), decltype(equal)> seen(v.size(), hash, equal);
+    std::vector<bool> is_duplicate(v.size());
+    for (size_t i = 0; i < v.size(); ++i) {
+        if (!seen.insert(i).second)
+            is_duplicate[i] = true;
+    }
+
+    size_t num_kept = 0;
+    for (size_t i = 0; i < v.size(); ++i) {
+        if (!is_duplicate[i])
+            v[num_kept++] = std::move(v[i]);
+    }
+    v.erase(v.begin() + num_kept, v.end());
+}
+
+} // anonymous namespace
+
 BaseDescriptor::Sorter DistinctDescriptor::sorter(Table const& table, const IndexPairs& indexes) const
 {
     REALM_ASSERT(!m_column_keys.empty());
@@ -220,8 +283,16 @@ void DistinctDescriptor::execute(IndexPairs& v, const Sorter& predicate, const B
         v.erase(nulls, v.end());
     }
 
+    if (predicate.is_hashable()) {
+        // Find duplicates in a single pass over the elements, keeping the first
+        // occurrence of each distinct value. This preserves the current order,
+        // so nothing needs to be restored afterwards.
+        distinct_by_hash(v, predicate);
+        return;
+    }
+
     // Sort by the columns to distinct on
-    std::sort(v.begin(), v.end(), std::ref(predicate));
+    predicate.sort(v);
 
     // Move duplicates to the back - "not less than" is "equal" since they're sorted
     auto duplicates = std::unique(v.begin(), v.end(), [&](const IP& a, const IP& b) {
@@ -247,7 +318,21 @@ BaseDescriptor::Sorter SortDescriptor::sorter(Table const& table, const IndexPai
 
 void SortDescriptor::execute(IndexPairs& v, const Sorter& predicate, const BaseDescriptor* next) const
 {
-    std::sort(v.begin(), v.end(), std::ref(predicate));
+    // If the next step is a limit, only the elements that survive the limit
+    // need to be sorted. Select them with nth_element and sort just those.
+    // The predicate is a total ordering, so the result is the same as that of
+    // a full sort followed by the limit.
+    size_t limit = size_t(-1);
+    if (next && next->get_type() == DescriptorType::Limit)
+        limit = static_cast<const LimitDescriptor*>(next)->get_limit();
+
+    if (limit < v.size()) {
+        std::nth_element(v.begin(), v.begin() + limit, v.end(), std::ref(predicate));
+        std::sort(v.begin(), v.begin() + limit, std::ref(predicate));
+    }
+    else {
+        predicate.sort(v);
+    }
 
     // not doing this on the last step is an optimisation
     if (next) {
@@ -353,6 +438,206 @@ void BaseDescriptor::Sorter::cache_first_column(IndexPairs& v)
     }
 }
 
+Mixed BaseDescriptor::Sorter::get_value(size_t t, IndexPair i) const
+{
+    if (t == 0)
+        return i.cached_value;
+
+    auto& col = m_columns[t];
+    ObjKey key = i.key_for_object;
+    if (!col.translated_keys.empty())
+        key = col.translated_keys[i.index_in_view];
+    return col.table->get_object(key).get_any(col.col_key);
+}
+
+bool BaseDescriptor::Sorter::is_hashable() const
+{
+    // Floating point and decimal values can compare equal while having
+    // different representations (e.g. 0.0 and -0.0), and values in Mixed
+    // columns can compare equal across types, so those are excluded.
+    return std::all_of(m_columns.begin(), m_columns.end(), [](auto&& col) {
+        if (col.col_key.get_attrs().test(col_attr_Collection))
+            return false;
+        switch (col.col_key.get_type()) {
+            case col_type_Int:
+            case col_type_Bool:
+            case col_type_String:
+            case col_type_Binary:
+            case col_type_Timestamp:
+            case col_type_ObjectId:
+            case col_type_UUID:
+            case col_type_Link:
+                return true;
+            default:
+                return false;
+        }
+    });
+}
+
+namespace {
+
+// An element to be radix sorted. The sort key is the concatenation of hi and
+// lo, compared as unsigned integers.
+struct RadixEntry {
+    uint64_t hi;
+    uint64_t lo;
+    size_t pos;
+};
+
+uint64_t read_big_endian(const uint8_t* bytes, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i)
+        value = (value << 8) | (i < size ? bytes[i] : 0);
+    return value;
+}
+
+// Produces an unsigned key with the same ordering as Mixed::compare() for
+// non-null values of the given column type. Returns false if the column type
+// is not supported.
+bool make_radix_key(const Mixed& value, ColumnType type, uint64_t& hi, uint64_t& lo)
+{
+    const uint64_t sign_bit = uint64_t(1) << 63;
+    switch (type) {
+        case col_type_Int:
+            hi = uint64_t(value.get_int()) ^ sign_bit;
+            lo = 0;
+            return true;
+        case col_type_Bool:
+            hi = value.get_bool() ? 1 : 0;
+            lo = 0;
+            return true;
+        case col_type_Timestamp: {
+            Timestamp ts = value.get_timestamp();
+            hi = uint64_t(ts.get_seconds()) ^ sign_bit;
+            lo = uint64_t(int64_t(ts.get_nanoseconds())) ^ sign_bit;
+            return true;
+        }
+        case col_type_ObjectId: {
+            auto bytes = value.get_object_id().to_bytes();
+            hi = read_big_endian(bytes.data(), 8);
+            lo = read_big_endian(bytes.data() + 8, bytes.size() - 8);
+            return true;
+        }
+        case col_type_UUID: {
+            auto bytes = value.get_uuid().to_bytes();
+            hi = read_big_endian(bytes.data(), 8);
+            lo = read_big_endian(bytes.data() + 8, bytes.size() - 8);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+// Stable LSD radix sort of \a entries on the 16 byte key. Byte positions
+// where all keys agree are skipped.
+void radix_sort(std::vector<RadixEntry>& entries)
+{
+    const size_t num_bytes = 16;
+    std::vector<std::array<size_t, 256>> counts(num_bytes);
+    auto get_byte = [](const RadixEntry& e, size_t b) {
+        return b < 8 ? uint8_t(e.lo >> (8 * b)) : uint8_t(e.hi >> (8 * (b - 8)));
+    };
+    for (auto& c : counts)
+        c.fill(0);
+    for (auto& e : entries) {
+        for (size_t b = 0; b < num_bytes; ++b)
+            ++counts[b][get_byte(e, b)];
+    }
+
+    std::vector<RadixEntry> buffer(entries.size());
+    for (size_t b = 0; b < num_bytes; ++b) {
+        auto& c = counts[b];
+        if (c[get_byte(entries.front(), b)] == entries.size())
+            continue;
+        size_t offset = 0;
+        for (auto& count : c) {
+            size_t n = count;
+            count = offset;
+            offset += n;
+        }
+        for (auto& e : entries)
+            buffer[c[get_byte(e, b)]++] = e;
+        entries.swap(buffer);
+    }
+}
+
+// Views smaller than this are sorted with std::sort.
+const size_t s_radix_sort_min_size = 1000;
+
+} // anonymous namespace
+
+void BaseDescriptor::Sorter::sort(IndexPairs& v) const
+{
+    if (v.size() < s_radix_sort_min_size || m_columns.empty() || !m_columns[0].translated_keys.empty() ||
+        m_columns[0].col_key.get_attrs().test(col_attr_Collection)) {
+        std::sort(v.begin(), v.end(), std::ref(*this));
+        return;
+    }
+
+    // The radix sort is stable, so ties must be in the order of index_in_view
+    // to begin with. This is normally already the case.
+    if (!std::is_sorted(v.begin(), v.end()))
+        std::sort(v.begin(), v.end());
+
+    const ColumnType type = m_columns[0].col_key.get_type();
+    const bool ascending = m_columns[0].ascending;
+    std::vector<RadixEntry> entries;
+    std::vector<size_t> nulls;
+    entries.reserve(v.size());
+    for (size_t i = 0; i < v.size(); ++i) {
+        const Mixed& value = v[i].cached_value;
+        if (value.is_null()) {
+            nulls.push_back(i);
+            continue;
+        }
+        RadixEntry e;
+        e.pos = i;
+        if (!make_radix_key(value, type, e.hi, e.lo)) {
+            std::sort(v.begin(), v.end(), std::ref(*this));
+            return;
+        }
+        if (!ascending) {
+            e.hi = ~e.hi;
+            e.lo = ~e.lo;
+        }
+        entries.push_back(e);
+    }
+    if (!entries.empty())
+        radix_sort(entries);
+
+    // Nulls come first in ascending order, and last in descending order.
+    IndexPairs sorted;
+    sorted.reserve(v.size());
+    if (ascending) {
+        for (size_t i : nulls)
+            sorted.push_back(std::move(v[i]));
+    }
+    for (auto& e : entries)
+        sorted.push_back(std::move(v[e.pos]));
+    if (!ascending) {
+        for (size_t i : nulls)
+            sorted.push_back(std::move(v[i]));
+    }
+    sorted.m_removed_by_limit = v.m_removed_by_limit;
+    v = std::move(sorted);
+
+    // Elements with equal values in the first column are ordered by the
+    // remaining columns.
+    if (m_columns.size() > 1) {
+        auto begin = v.begin();
+        while (begin != v.end()) {
+            auto end = std::find_if(begin + 1, v.end(), [&](const IndexPair& p) {
+                return p.cached_value.compare(begin->cached_value) != 0;
+            });
+            if (end - begin > 1)
+                std::sort(begin, end, std::ref(*this));
+            begin = end;
+        }
+    }
+}
+
 DescriptorOrdering::DescriptorOrdering(const DescriptorOrdering& other)
 {
     for (const auto& d : other.m_descriptors) {
@@ -94,6 +94,27 @@ public:
         }
         void cache_first_column(IndexPairs& v);
 
+        // Sorts \a v according to this sorter, with the same result as
+        // std::sort() using the sorter as predicate. The first column must
+        // have been cached. Large views sorted by a column of integer,
+        // boolean, timestamp, ObjectId or UUID type are radix sorted on the
+        // cached values, which avoids comparing Mixed values.
+        void sort(IndexPairs& v) const;
+
+        size_t num_columns() const
+        {
+            return m_columns.size();
+        }
+
+        // Returns the value of column \a t for the element \a i. The value of
+        // the first column is taken from the cache made by cache_first_column().
+        Mixed get_value(size_t t, IndexPair i) const;
+
+        // Returns true if values of all the columns can be compared for
+        // equality through their hash, such that duplicates can be found
+        // without sorting.
+        bool is_hashable() const;
+
     private:
         struct SortColumn {
             SortColumn(const Table* t, ColKey c, bool a)
@@ -556,6 +556,10 @@ inline ClientImpl::ClientImpl(Client::Config config)
                  config.fast_reconnect_limit); // Throws
     logger.debug("Config param: disable_upload_compaction = %1",
                  config.disable_upload_compaction); // Throws
+    logger.debug("Config param: upload_coalescing_max_size = %1",
+                 config.upload_coalescing_max_size); // Throws
+    logger.debug("Config param: upload_coalescing_max_timespan = %1 ms",
+                 config.upload_coalescing_max_timespan); // Throws
     logger.debug("Config param: tcp_no_delay = %1",
                  config.tcp_no_delay); // Throws
     logger.debug("Config param: disable_sync_to_disk = %1",
@@ -730,6 +734,8 @@ ClientImplBase::Config ClientImpl::make_client_impl_base_config(Client::Config&
     config_2.tcp_no_delay                    = config.tcp_no_delay;
     config_2.enable_default_port_hack        = config.enable_default_port_hack;
     config_2.disable_upload_compaction       = config.disable_upload_compaction;
+    config_2.upload_coalescing_max_size      = config.upload_coalescing_max_size;
+    config_2.upload_coalescing_max_timespan  = config.upload_coalescing_max_timespan;
     config_2.roundtrip_time_handler          = std::move(config.roundtrip_time_handler);
     // clang-format on
 
@@ -193,6 +193,26 @@ public:
         /// consumption.
         bool disable_upload_compaction = false;
 
+        /// If nonzero, consecutive local changesets are coalesced into a
+        /// single changeset before they are uploaded, as long as the
+        /// accumulated size of the original changesets does not exceed
+        /// `upload_coalescing_max_size` bytes. This reduces the number of
+        /// changesets that the server has to integrate when the application
+        /// makes many small write transactions. Only changesets that were
+        /// produced on top of the same server version are coalesced. If zero,
+        /// every changeset is uploaded separately.
+        ///
+        /// Note that coalesced changesets hide the intermediate states from
+        /// other clients, and that all instructions of a coalesced changeset
+        /// are given the timestamp of the last original changeset.
+        std::size_t upload_coalescing_max_size = 0;
+
+        /// The maximum difference between the origin timestamps of the first
+        /// and the last changeset in a group of coalesced changesets. This
+        /// bounds how much conflict resolution between concurrent writes can
+        /// be affected by upload coalescing. See `upload_coalescing_max_size`.
+        milliseconds_type upload_coalescing_max_timespan = 1000; // 1 second
+
         /// Set the `TCP_NODELAY` option on all TCP/IP sockets. This disables
         /// the Nagle algorithm. Disabling it, can in some cases be used to
         /// decrease latencies, but possibly at the expense of scalability. Be
@@ -118,6 +118,8 @@ ClientImplBase::ClientImplBase(Config config)
     , m_tcp_no_delay{config.tcp_no_delay}
     , m_enable_default_port_hack{config.enable_default_port_hack}
     , m_disable_upload_compaction{config.disable_upload_compaction}
+    , m_upload_coalescing_max_size{config.upload_coalescing_max_size}
+    , m_upload_coalescing_max_timespan{config.upload_coalescing_max_timespan}
     , m_roundtrip_time_handler{std::move(config.roundtrip_time_handler)}
     , m_user_agent_string{make_user_agent_string(config)} // Throws
     , m_service{}                                         // Throws
@@ -2254,53 +2256,108 @@ void Session::send_upload_message()
     ClientProtocol::UploadMessageBuilder upload_message_builder =
         protocol.make_upload_message_builder(logger); // Throws
 
-    for (const UploadChangeset& uc : uploadable_changesets) {
-        logger.trace("Fetching changeset for upload (client_version=%1, server_version=%2, "
-                     "changeset_size=%3, origin_timestamp=%4, origin_file_ident=%5)",
-                     uc.progress.client_version, uc.progress.last_integrated_server_version, uc.changeset.size(),
-                     uc.origin_timestamp, uc.origin_file_ident); // Throws
-        if (logger.would_log(util::Logger::Level::trace)) {
-            BinaryData changeset_data = uc.changeset.get_first_chunk();
-            if (changeset_data.size() < 1024) {
-                logger.trace("Changeset: %1",
-                             _impl::clamped_hex_dump(changeset_data)); // Throws
+    bool disable_upload_compaction = get_client().m_disable_upload_compaction;
+    std::size_t max_coalesced_size = get_client().m_upload_coalescing_max_size;
+    milliseconds_type max_coalesced_timespan = get_client().m_upload_coalescing_max_timespan;
+    std::size_t num_changesets = uploadable_changesets.size();
+    std::size_t begin = 0;
+    while (begin < num_changesets) {
+        // Find the longest run of changesets that can be coalesced with the
+        // one at `begin`. Only changesets that were produced on top of the same
+        // server version can be coalesced, because the server transforms the
+        // uploaded changeset against everything after that version.
+        const UploadChangeset& first = uploadable_changesets[begin];
+        std::size_t end = begin + 1;
+        if (max_coalesced_size > 0) {
+            std::size_t accum_size = first.changeset.size();
+            while (end < num_changesets) {
+                const UploadChangeset& uc = uploadable_changesets[end];
+                bool can_coalesce =
+                    (uc.progress.last_integrated_server_version == first.progress.last_integrated_server_version &&
+                     uc.origin_file_ident == first.origin_file_ident &&
+                     uc.origin_timestamp >= first.origin_timestamp &&
+                     uc.origin_timestamp - first.origin_timestamp <= timestamp_type(max_coalesced_timespan) &&
+                     accum_size + uc.changeset.size() <= max_coalesced_size);
+                if (!can_coalesce)
+                    break;
+                accum_size += uc.changeset.size();
+                ++end;
             }
-            else {
-                logger.trace("Changeset(comp): %1 % 2", changeset_data.size(),
-                             protocol.compressed_hex_dump(changeset_data));
+        }
+
+        for (std::size_t i = begin; i < end; ++i) {
+            const UploadChangeset& uc = uploadable_changesets[i];
+            logger.trace("Fetching changeset for upload (client_version=%1, server_version=%2, "
+                         "changeset_size=%3, origin_timestamp=%4, origin_file_ident=%5)",
+                         uc.progress.client_version, uc.progress.last_integrated_server_version,
+                         uc.changeset.size(), uc.origin_timestamp, uc.origin_file_ident); // Throws
+            if (logger.would_log(util::Logger::Level::trace)) {
+                BinaryData changeset_data = uc.changeset.get_first_chunk();
+                if (changeset_data.size() < 1024) {
+                    logger.trace("Changeset: %1",
+                                 _impl::clamped_hex_dump(changeset_data)); // Throws
+                }
+                else {
+                    logger.trace("Changeset(comp): %1 % 2", changeset_data.size(),
+                                 protocol.compressed_hex_dump(changeset_data));
+                }
             }
         }
 
-        if (!get_client().m_disable_upload_compaction) {
-            // Upload compaction only takes place within single changesets to
-            // avoid another client seeing inconsistent snapshots.
-            ChunkedBinaryInputStream stream{uc.changeset};
-            sync::Changeset changeset;
-            sync::parse_changeset(stream, changeset); // Throws
-            // FIXME: What is the point of setting these? How can compaction care about them?
-            changeset.version = uc.progress.client_version;
-            changeset.last_integrated_remote_version = uc.progress.last_integrated_server_version;
-            changeset.origin_timestamp = uc.origin_timestamp;
-            changeset.origin_file_ident = uc.origin_file_ident;
+        // A coalesced changeset takes the place of the last changeset in the
+        // run, so that the upload progress is unaffected.
+        const UploadChangeset& last = uploadable_changesets[end - 1];
+        std::size_t num_coalesced = end - begin;
+        if (num_coalesced == 1 && disable_upload_compaction) {
+            upload_message_builder.add_changeset(last.progress.client_version,
+                                                 last.progress.last_integrated_server_version, last.origin_timestamp,
+                                                 last.origin_file_ident,
+                                                 last.changeset); // Throws
+        }
+        else {
+            std::vector<sync::Changeset> changesets(num_coalesced); // Throws
+            std::size_t original_size = 0;
+            for (std::size_t i = 0; i < num_coalesced; ++i) {
+                const UploadChangeset& uc = uploadable_changesets[begin + i];
+                ChunkedBinaryInputStream stream{uc.changeset};
+                sync::Changeset& changeset = changesets[i];
+                sync::parse_changeset(stream, changeset); // Throws
+                // FIXME: What is the point of setting these? How can compaction care about them?
+                changeset.version = uc.progress.client_version;
+                changeset.last_integrated_remote_version = uc.progress.last_integrated_server_version;
+                changeset.origin_timestamp = uc.origin_timestamp;
+                changeset.origin_file_ident = uc.origin_file_ident;
+                original_size += uc.changeset.size();
+            }
 
-            compact_changesets(&changeset, 1);
+            // Upload compaction only takes place within the changesets that
+            // are coalesced into one, to avoid another client seeing
+            // inconsistent snapshots.
+            if (!disable_upload_compaction)
+                compact_changesets(changesets.data(), changesets.size()); // Throws
 
             util::AppendBuffer<char> encode_buffer;
-            encode_changeset(changeset, encode_buffer);
+            if (num_coalesced == 1) {
+                encode_changeset(changesets.front(), encode_buffer); // Throws
+            }
+            else {
+                sync::Changeset coalesced;
+                concatenate_changesets(changesets.data(), changesets.size(), coalesced); // Throws
+                encode_changeset(coalesced, encode_buffer);                               // Throws
+                logger.debug("Upload coalescing: %1 changesets (client_version=%2 to %3) coalesced into one",
+                             num_coalesced, first.progress.client_version,
+                             last.progress.client_version); // Throws
+            }
 
-            logger.debug("Upload compaction: original size = %1, compacted size = %2", uc.changeset.size(),
+            logger.debug("Upload compaction: original size = %1, compacted size = %2", original_size,
                          encode_buffer.size()); // Throws
 
             upload_message_builder.add_changeset(
-                uc.progress.client_version, uc.progress.last_integrated_server_version, uc.origin_timestamp,
-                uc.origin_file_ident, BinaryData{encode_buffer.data(), encode_buffer.size()}); // Throws
-        }
-        else {
-            upload_message_builder.add_changeset(uc.progress.client_version,
-                                                 uc.progress.last_integrated_server_version, uc.origin_timestamp,
-                                                 uc.origin_file_ident,
-                                                 uc.changeset); // Throws
+                last.progress.client_version, last.progress.last_integrated_server_version, last.origin_timestamp,
+                last.origin_file_ident, BinaryData{encode_buffer.data(), encode_buffer.size()}); // Throws
         }
+
+        begin = end;
     }
 
     int protocol_version = m_conn.get_negotiated_protocol_version();
@@ -94,6 +94,8 @@ private:
     const bool m_tcp_no_delay;
     const bool m_enable_default_port_hack;
     const bool m_disable_upload_compaction;
+    const std::size_t m_upload_coalescing_max_size;
+    const milliseconds_type m_upload_coalescing_max_timespan;
     const std::function<RoundtripTimeHandler> m_roundtrip_time_handler;
     const std::string m_user_agent_string;
     util::network::Service m_service;
@@ -134,6 +136,8 @@ public:
     bool tcp_no_delay = false;
     bool enable_default_port_hack = false;
     bool disable_upload_compaction = false;
+    std::size_t upload_coalescing_max_size = 0;
+    milliseconds_type upload_coalescing_max_timespan = 1000;
     std::function<RoundtripTimeHandler> roundtrip_time_handler;
 };
 
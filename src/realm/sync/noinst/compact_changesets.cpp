@@ -432,3 +432,85 @@ void realm::_impl::compact_changesets(Changeset*, size_t)
     compactor.compact(); // Throws
 #endif
 }
+
+void realm::_impl::concatenate_changesets(const Changeset* changesets, size_t num_changesets, Changeset& out)
+{
+    using Instruction = sync::Instruction;
+
+    for (size_t i = 0; i < num_changesets; ++i) {
+        const Changeset& in = changesets[i];
+
+        auto copy_intern_string = [&](InternString& str) {
+            str = out.intern_string(in.get_string(str)); // Throws
+        };
+
+        auto copy_string_range = [&](StringBufferRange& range) {
+            range = out.append_string(in.get_string(range)); // Throws
+        };
+
+        auto copy_key = [&](Instruction::PrimaryKey& key) {
+            if (auto str = mpark::get_if<InternString>(&key))
+                copy_intern_string(*str); // Throws
+        };
+
+        auto copy_payload = [&](Instruction::Payload& payload) {
+            using Type = Instruction::Payload::Type;
+            switch (payload.type) {
+                case Type::String:
+                    return copy_string_range(payload.data.str); // Throws
+                case Type::Binary:
+                    return copy_string_range(payload.data.binary); // Throws
+                case Type::Link:
+                    copy_intern_string(payload.data.link.target_table); // Throws
+                    return copy_key(payload.data.link.target);          // Throws
+                default:
+                    return;
+            }
+        };
+
+        for (auto instr : in) {
+            if (!instr)
+                continue;
+
+            Instruction copy = *instr;
+            auto& table_instr = copy.get_as<Instruction::TableInstruction>();
+            copy_intern_string(table_instr.table); // Throws
+            if (auto object_instr = copy.get_if<Instruction::ObjectInstruction>()) {
+                copy_key(object_instr->object); // Throws
+                if (auto path_instr = copy.get_if<Instruction::PathInstruction>()) {
+                    copy_intern_string(path_instr->field); // Throws
+                    for (auto& element : path_instr->path.m_path) {
+                        if (auto str = mpark::get_if<InternString>(&element))
+                            copy_intern_string(*str); // Throws
+                    }
+                }
+                if (auto update_instr = copy.get_if<Instruction::Update>()) {
+                    copy_payload(update_instr->value); // Throws
+                }
+                else if (auto insert_instr = copy.get_if<Instruction::ArrayInsert>()) {
+                    copy_payload(insert_instr->value); // Throws
+                }
+                else if (auto set_insert_instr = copy.get_if<Instruction::SetInsert>()) {
+                    copy_payload(set_insert_instr->value); // Throws
+                }
+                else if (auto set_erase_instr = copy.get_if<Instruction::SetErase>()) {
+                    copy_payload(set_erase_instr->value); // Throws
+                }
+            }
+            else if (auto add_table_instr = copy.get_if<Instruction::AddTable>()) {
+                if (auto spec = mpark::get_if<Instruction::AddTable::PrimaryKeySpec>(&add_table_instr->type))
+                    copy_intern_string(spec->field); // Throws
+            }
+            else if (auto add_column_instr = copy.get_if<Instruction::AddColumn>()) {
+                copy_intern_string(add_column_instr->field); // Throws
+                if (add_column_instr->type == Instruction::Payload::Type::Link)
+                    copy_intern_string(add_column_instr->link_target_table); // Throws
+            }
+            else if (auto erase_column_instr = copy.get_if<Instruction::EraseColumn>()) {
+                copy_intern_string(erase_column_instr->field); // Throws
+            }
+
+            out.push_back(copy); // Throws
+        }
+    }
+}
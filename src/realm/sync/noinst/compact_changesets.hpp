@@ -35,6 +35,18 @@ namespace _impl {
 /// other threads.
 void compact_changesets(realm::sync::Changeset* changesets, size_t num_changesets);
 
+/// Append the instructions of the specified changesets to \a out, in order,
+/// such that applying \a out has the same effect as applying each of the
+/// changesets in turn.
+///
+/// The strings referenced by the appended instructions are copied into, and
+/// interned in the string buffer of \a out. The metadata of \a out (version,
+/// timestamp, ...) is left untouched.
+///
+/// This function may throw exceptions due to the fact that it allocates memory.
+void concatenate_changesets(const realm::sync::Changeset* changesets, size_t num_changesets,
+                            realm::sync::Changeset& out);
+
 } // namespace _impl
 } // namespace realm
 
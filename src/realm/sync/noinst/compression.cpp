@@ -1058,15 +1058,16 @@ std::error_code compression::extract_blocks_from_encrypted_realm(const std::stri
         REALM_ASSERT(size_to_read % encryption_block_size == 0);
         REALM_ASSERT(decrypted_src_size % encryption_block_size == 0);
         REALM_ASSERT(decrypted_offset % encryption_block_size == 0);
-        // We loop over all individual encryption blocks because aes_cryptor.read() returns false
-        // for uninitialized blocks. Those blocks are not used by any Realm data structures but they
-        // must be included in the file as well.
-        for (std::size_t pos = 0; pos < size_to_read; pos += encryption_block_size) {
-            bool success = aes_cryptor.read(file.get_descriptor(), off_t(decrypted_offset + pos),
-                                            unencrypted_buf.get() + pos, encryption_block_size);
-            if (!success) {
+        // aes_cryptor.read() stops at uninitialized blocks, so we loop until all blocks have been
+        // read. Those blocks are not used by any Realm data structures but they must be included in
+        // the file as well.
+        for (std::size_t pos = 0; pos < size_to_read;) {
+            pos += aes_cryptor.read(file.get_descriptor(), off_t(decrypted_offset + pos),
+                                    unencrypted_buf.get() + pos, size_to_read - pos);
+            if (pos < size_to_read) {
                 // zero out the content.
                 std::memset(unencrypted_buf.get() + pos, 0, encryption_block_size);
+                pos += encryption_block_size;
             }
 
             // The logic here is strange, because we capture uninitialized blocks, but blocks that
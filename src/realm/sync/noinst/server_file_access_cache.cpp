@@ -35,6 +35,16 @@ void ServerFileAccessCache::access(Slot& slot)
     }
 
     slot.open(); // Throws
+
+    // Close least recently accessed Realm files until the accumulated size of
+    // the open files is within budget again
+    if (m_max_open_files_size != 0) {
+        while (m_open_files_size > m_max_open_files_size && m_num_open_files > 1) {
+            Slot& least_recently_accessed = *m_first_open_file->m_prev_open_file;
+            REALM_ASSERT(&least_recently_accessed != &slot);
+            least_recently_accessed.proper_close(); // Throws
+        }
+    }
 }
 
 void ServerFileAccessCache::poll_core_metrics()
@@ -166,9 +176,21 @@ void ServerFileAccessCache::Slot::open()
 
     m_cache.m_logger.detail("Opening Realm file: %1", realm_path); // Throws
 
-    m_file.reset(new File{*this}); // Throws
+    auto start_time = std::chrono::steady_clock::now();
+    std::unique_ptr<File> file{new File{*this}}; // Throws
+    auto open_time = std::chrono::steady_clock::now() - start_time;
+    if (m_cache.m_metrics) {
+        double milliseconds = std::chrono::duration<double, std::milli>(open_time).count();
+        m_cache.m_metrics->timing("realms.open_time", milliseconds); // Throws
+    }
+
+    // The file exists at this point, as it has just been opened
+    std::uint_fast64_t file_size = std::uint_fast64_t(util::File{realm_path}.get_size()); // Throws
 
+    m_file = std::move(file);
+    m_file_size = file_size;
     m_cache.insert(*this);
     m_cache.m_first_open_file = this;
     ++m_cache.m_num_open_files;
+    m_cache.m_open_files_size += m_file_size;
 }
@@ -28,11 +28,17 @@ public:
     /// \param max_open_files The maximum number of Realm files to keep open
     /// concurrently. Must be greater than or equal to 1.
     ///
+    /// \param max_open_files_size The maximum accumulated size in bytes of the
+    /// Realm files to keep open concurrently, as measured when they are
+    /// opened. When exceeded, least recently accessed files are closed, but the
+    /// most recently accessed file is always kept open. Zero means no limit.
+    ///
     /// The specified history context will not be accessed on behalf of this
     /// cache object before the first invocation of Slot::access() on an
     /// associated file file slot.
-    ServerFileAccessCache(long max_open_files, util::Logger&, ServerHistory::Context&,
-                          util::Optional<std::array<char, 64>> encryption_key, sync::Metrics* metrics);
+    ServerFileAccessCache(long max_open_files, std::uint_fast64_t max_open_files_size, util::Logger&,
+                          ServerHistory::Context&, util::Optional<std::array<char, 64>> encryption_key,
+                          sync::Metrics* metrics);
 
     ~ServerFileAccessCache() noexcept;
 
@@ -49,7 +55,11 @@ private:
     /// Current number of open Realm files.
     long m_num_open_files = 0;
 
+    /// Current accumulated size of open Realm files.
+    std::uint_fast64_t m_open_files_size = 0;
+
     const long m_max_open_files;
+    const std::uint_fast64_t m_max_open_files_size;
     const util::Optional<std::array<char, 64>> m_encryption_key;
     util::Logger& m_logger;
     ServerHistory::Context& m_history_context;
@@ -111,6 +121,9 @@ private:
 
     std::unique_ptr<File> m_file;
 
+    // Size of the Realm file when it was opened
+    std::uint_fast64_t m_file_size = 0;
+
     void open();
     void do_close() noexcept;
 
@@ -132,11 +145,12 @@ private:
 
 // Implementation
 
-inline ServerFileAccessCache::ServerFileAccessCache(long max_open_files, util::Logger& logger,
-                                                    ServerHistory::Context& history_context,
+inline ServerFileAccessCache::ServerFileAccessCache(long max_open_files, std::uint_fast64_t max_open_files_size,
+                                                    util::Logger& logger, ServerHistory::Context& history_context,
                                                     util::Optional<std::array<char, 64>> encryption_key,
                                                     sync::Metrics* metrics)
     : m_max_open_files{max_open_files}
+    , m_max_open_files_size{max_open_files_size}
     , m_encryption_key{encryption_key}
     , m_logger{logger}
     , m_history_context{history_context}
@@ -248,8 +262,10 @@ inline void ServerFileAccessCache::Slot::do_close() noexcept
 {
     REALM_ASSERT(is_open());
     --m_cache.m_num_open_files;
+    m_cache.m_open_files_size -= m_file_size;
     m_cache.remove(*this);
     m_file.reset();
+    m_file_size = 0;
 }
 
 inline ServerFileAccessCache::File::File(const Slot& slot)
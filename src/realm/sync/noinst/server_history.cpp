@@ -310,9 +310,41 @@ constexpr ServerHistory::file_ident_type g_root_node_file_ident = 1;
 
 const AllocationMetricName g_log_compaction_metric{"log_compaction"};
 
+
+bool is_same_changeset(const ChunkedBinaryData& changeset, const util::AppendBuffer<char>& buffer) noexcept
+{
+    if (changeset.size() != buffer.size())
+        return false;
+    ChunkedBinaryInputStream stream{changeset};
+    const char* pos = buffer.data();
+    const char* begin;
+    const char* end;
+    while (stream.next_block(begin, end)) {
+        if (!std::equal(begin, end, pos))
+            return false;
+        pos += end - begin;
+    }
+    return true;
+}
+
 } // unnamed namespace
 
 
+std::uint_fast64_t _impl::get_history_compaction_tier_begin(std::uint_fast64_t compacted_until,
+                                                            std::uint_fast64_t compact_until) noexcept
+{
+    REALM_ASSERT(compacted_until < compact_until);
+    // The highest bit in which the two differ determines the tier level
+    std::uint_fast64_t diff = compacted_until ^ compact_until;
+    int level = 0;
+    while (diff >> 1 >> level != 0)
+        ++level;
+    std::uint_fast64_t block_size = std::uint_fast64_t(1) << level;
+    std::uint_fast64_t block_end = compact_until & ~(block_size - 1);
+    return block_end - block_size;
+}
+
+
 void ServerHistory::get_status(VersionInfo& version_info, bool& has_upstream_sync_status,
                                file_ident_type& partial_file_ident,
                                version_type& partial_progress_reference_version) const
@@ -352,6 +384,26 @@ version_type ServerHistory::get_compacted_until_version() const
 }
 
 
+std::uint_fast64_t ServerHistory::get_downloadable_bytes(version_type server_version) const
+{
+    TransactionRef rt = m_shared_group->start_read(); // Throws
+    version_type realm_version = rt->get_version();
+    const_cast<ServerHistory*>(this)->set_group(rt.get());
+    ensure_updated(realm_version); // Throws
+    if (m_history_size == 0)
+        return 0;
+    std::int_fast64_t cumulative_byte_size_current = 0;
+    if (server_version > m_history_base_version) {
+        std::size_t ndx = to_size_t(server_version - m_history_base_version) - 1;
+        REALM_ASSERT(ndx < m_history_size);
+        cumulative_byte_size_current = m_acc->sh_cumul_byte_sizes.get(ndx);
+    }
+    std::int_fast64_t cumulative_byte_size_total = m_acc->sh_cumul_byte_sizes.get(m_history_size - 1);
+    REALM_ASSERT(cumulative_byte_size_current <= cumulative_byte_size_total);
+    return std::uint_fast64_t(cumulative_byte_size_total - cumulative_byte_size_current);
+}
+
+
 void ServerHistory::allocate_file_identifiers(FileIdentAllocSlots& slots, VersionInfo& version_info)
 {
     TransactionRef tr = m_shared_group->start_write(); // Throws
@@ -1322,15 +1374,24 @@ bool ServerHistory::do_compact_history(Logger& logger, bool force)
 
     dirty = true;
 
-    std::size_t num_compactable_changesets = std::size_t(can_compact_until_version - m_history_base_version);
-    version_type compaction_begin_version = m_history_base_version; // always 0 for now
+    // Only the tier that is completed by this run is compacted, see
+    // get_history_compaction_tier_begin().
+    version_type compaction_begin_version =
+        m_history_base_version +
+        version_type(get_history_compaction_tier_begin(compacted_until_version - m_history_base_version,
+                                                       can_compact_until_version - m_history_base_version));
+    std::size_t num_compactable_changesets = std::size_t(can_compact_until_version - compaction_begin_version);
+    std::size_t tier_begin_index = std::size_t(compaction_begin_version - m_history_base_version);
+    logger.debug("History compaction: Compacting tier of %1 changesets starting after version %2",
+                 num_compactable_changesets, compaction_begin_version); // Throws
     std::size_t before_size = 0;
     std::size_t after_size = 0;
+    std::size_t num_rewritten_changesets = 0;
 
     // Chunk compactions to limit memory usage.
     while (compaction_begin_version < can_compact_until_version) {
         auto num_compactable_changesets_this_iteration =
-            size_t(num_compactable_changesets - (compaction_begin_version - m_history_base_version));
+            size_t(can_compact_until_version - compaction_begin_version);
         std::vector<Changeset> compact_bootstrap_changesets;
         compact_bootstrap_changesets.resize(num_compactable_changesets_this_iteration); // Throws
         version_type begin_version = compaction_begin_version;
@@ -1359,28 +1420,40 @@ bool ServerHistory::do_compact_history(Logger& logger, bool force)
             if (compaction_input_size >= compaction_input_soft_limit)
                 break;
         }
+        // Discard the slots that were not filled due to the soft limit, as
+        // they would otherwise be written back as empty changesets.
+        compact_bootstrap_changesets.resize(std::size_t(end_version - begin_version));
 
         compact_changesets(compact_bootstrap_changesets.data(),
                            compact_bootstrap_changesets.size()); // Throws
 
 
         util::AppendBuffer<char> buffer;
-        for (std::size_t i = 0; i < num_compactable_changesets_this_iteration; ++i) {
+        for (std::size_t i = 0; i < compact_bootstrap_changesets.size(); ++i) {
             buffer.clear();
             encode_changeset(compact_bootstrap_changesets[i], buffer);
             after_size += buffer.size();
             version_type server_version = begin_version + i + 1;
-            m_acc->sh_changesets.set(size_t(server_version - 1), BinaryData{buffer.data(), buffer.size()}); // Throws
+            // Leave unchanged changesets alone, to avoid needlessly copying
+            // them on write, which would bloat the Realm file.
+            std::size_t history_entry_index = std::size_t(server_version - 1 - m_history_base_version);
+            if (is_same_changeset(get_changeset(server_version), buffer))
+                continue;
+            m_acc->sh_changesets.set(history_entry_index, BinaryData{buffer.data(), buffer.size()}); // Throws
+            ++num_rewritten_changesets;
         }
         compaction_begin_version = end_version;
     }
 
-    // Recalculate the cumulative byte sizes.
+    // Recalculate the cumulative byte sizes. Those preceding the compacted
+    // tier are unaffected.
     {
         size_t num_history_entries = m_acc->sh_changesets.size();
         REALM_ASSERT(m_acc->sh_cumul_byte_sizes.size() == num_history_entries);
         size_t history_byte_size = 0;
-        for (size_t i = 0; i < num_history_entries; ++i) {
+        if (tier_begin_index > 0)
+            history_byte_size = size_t(m_acc->sh_cumul_byte_sizes.get(tier_begin_index - 1));
+        for (size_t i = tier_begin_index; i < num_history_entries; ++i) {
             size_t changeset_size = ChunkedBinaryData(m_acc->sh_changesets, i).size();
             history_byte_size += changeset_size;
             m_acc->sh_cumul_byte_sizes.set(i, history_byte_size);
@@ -1400,9 +1473,9 @@ bool ServerHistory::do_compact_history(Logger& logger, bool force)
     m_acc->root.set(s_compacted_until_version_iip,
                     RefOrTagged::make_tagged(can_compact_until_version)); // Throws
 
-    logger.detail("History compaction: Processed %1 changesets (saved %2 bytes in %3 "
-                  "milliseconds)",
-                  num_compactable_changesets, before_size - after_size,
+    logger.detail("History compaction: Processed %1 changesets, of which %2 were rewritten (saved %3 bytes "
+                  "in %4 milliseconds)",
+                  num_compactable_changesets, num_rewritten_changesets, before_size - after_size,
                   chrono::duration_cast<chrono::milliseconds>(new_now - now).count()); // Throws
     return dirty;
 }
@@ -107,6 +107,22 @@ constexpr int get_server_history_schema_version() noexcept
 }
 
 
+/// In-place history compaction proceeds in tiers, much like a binary counter.
+/// A compaction run that advances the compaction point from \a
+/// compacted_until to \a compact_until (both relative to the history base
+/// version) starts at the beginning of the largest aligned block of 2^L history
+/// entries that is completed by the run. Recent history is therefore compacted
+/// together with newer history frequently, while older history is only merged
+/// into larger tiers occasionally. The amortized cost of a run is thereby
+/// proportional to the amount of new history, rather than to the size of the
+/// entire history.
+///
+/// Returns the history-relative version at which compaction must start. It is
+/// always less than, or equal to \a compacted_until.
+std::uint_fast64_t get_history_compaction_tier_begin(std::uint_fast64_t compacted_until,
+                                                     std::uint_fast64_t compact_until) noexcept;
+
+
 class ServerHistory : public sync::ClientReplicationBase,
                       public _impl::History,
                       public std::enable_shared_from_this<ServerHistory> {
@@ -240,9 +256,17 @@ public:
     void get_status(sync::VersionInfo&, bool& has_upstream_status, file_ident_type& partial_file_ident,
                     version_type& partial_progress_reference_version) const;
 
-    /// For testing purposes
+    /// Returns the server version up until which in-place history compaction
+    /// has been carried out. This is also used by the server to decide whether
+    /// a cached bootstrap DOWNLOAD body is still usable.
     version_type get_compacted_until_version() const;
 
+    /// Returns the cumulative byte size of the changesets that follow the
+    /// specified server version in the history, that is, the number of bytes
+    /// that remain to be downloaded by a client whose download progress is at
+    /// that version.
+    std::uint_fast64_t get_downloadable_bytes(version_type server_version) const;
+
     /// Validate the specified client file identifier, download progress, and
     /// server version as received in an IDENT message. If they are valid, fetch
     /// the upload progress representing the last integrated changeset from the
@@ -3817,14 +3817,36 @@ private:
             bool enable_cache = (config.enable_download_bootstrap_cache && m_download_progress.server_version == 0 &&
                                  m_upload_progress.client_version == 0 && m_upload_threshold.client_version == 0);
             DownloadCache& cache = m_server_file->get_download_cache();
-            bool fetch_from_cache = (enable_cache && cache.body && end_version == cache.end_version);
+            bool fetch_from_cache = (enable_cache && cache.body);
+            if (fetch_from_cache && end_version != cache.end_version) {
+                // A cached body that lags behind the latest server version can
+                // still be used as a bootstrap snapshot, because the remaining
+                // changesets will be sent in subsequent DOWNLOAD messages. It
+                // must be rebuilt, though, when it lags too far behind, or when
+                // in-place history compaction has moved past its end version,
+                // as the tail may then no longer be downloadable from there.
+                REALM_ASSERT(cache.end_version < end_version);
+                fetch_from_cache =
+                    (end_version - cache.end_version <= config.download_bootstrap_cache_max_lag &&
+                     history.get_compacted_until_version() <= cache.end_version); // Throws
+            }
+            if (enable_cache)
+                metrics().increment(fetch_from_cache ? "download.bootstrap_cache.hit"
+                                                     : "download.bootstrap_cache.miss"); // Throws
             if (fetch_from_cache) {
                 body = cache.body.get();
                 uncompressed_body_size = cache.uncompressed_body_size;
                 compressed_body_size = cache.compressed_body_size;
                 body_is_compressed = cache.body_is_compressed;
                 download_progress = cache.download_progress;
-                downloadable_bytes = cache.downloadable_bytes;
+                if (end_version == cache.end_version) {
+                    downloadable_bytes = cache.downloadable_bytes;
+                }
+                else {
+                    // The changesets following the cached body remain to be
+                    // downloaded as well
+                    downloadable_bytes = history.get_downloadable_bytes(download_progress.server_version); // Throws
+                }
                 num_changesets = cache.num_changesets;
                 accum_original_size = cache.accum_original_size;
                 accum_compacted_size = cache.accum_compacted_size;
@@ -3881,12 +3903,15 @@ private:
                     return true;
                 };
                 if (enable_cache) {
+                    SteadyTimePoint build_start_time = steady_clock_now();
                     std::size_t max_download_size = std::numeric_limits<size_t>::max();
                     if (!fetch_and_compress(max_download_size)) { // Throws
                         // Session object may have been destroyed at this point
                         // (suicide).
                         return;
                     }
+                    metrics().timing("download.bootstrap_cache.build",
+                                     double(steady_duration(build_start_time))); // Throws
                     REALM_ASSERT(upload_progress.client_version == 0);
                     std::size_t body_size = (body_is_compressed ? compressed_body_size : uncompressed_body_size);
                     cache.body = std::make_unique<char[]>(body_size); // Throws
@@ -5139,8 +5164,8 @@ Worker::Worker(ServerImpl& server)
     , m_server{server}
     , m_transformer{make_transformer()} // Throws
     , m_integration_reporter{server}
-    , m_file_access_cache{server.get_config().max_open_files, logger, *this, server.get_config().encryption_key,
-                          server.get_config().metrics}
+    , m_file_access_cache{server.get_config().max_open_files, server.get_config().max_open_files_size, logger,
+                          *this, server.get_config().encryption_key, server.get_config().metrics}
     , m_allocation_metrics_context{AllocationMetricsContext::get_current()}
 {
     util::seed_prng_nondeterministically(m_random); // Throws
@@ -5254,7 +5279,8 @@ ServerImpl::ServerImpl(const std::string& root_dir, util::Optional<sync::PKey> p
     , m_root_dir{root_dir} // Throws
     , m_access_control{std::move(pkey)}
     , m_protocol_version_range{determine_protocol_version_range(config)}                                   // Throws
-    , m_file_access_cache{m_config.max_open_files, logger, *this, config.encryption_key, m_config.metrics} // Throws
+    , m_file_access_cache{m_config.max_open_files, m_config.max_open_files_size, logger, *this,
+                          config.encryption_key, m_config.metrics} // Throws
     , m_metrics{m_config.metrics ? *m_config.metrics : g_null_metrics}
     , m_worker{*this} // Throws
     , m_acceptor{get_service()}
@@ -5306,6 +5332,8 @@ void ServerImpl::start()
     }
     logger.info("Directory holding persistent state: %1", m_root_dir);        // Throws
     logger.info("Maximum number of open files: %1", m_config.max_open_files); // Throws
+    if (m_config.max_open_files_size != 0)
+        logger.info("Maximum size of open files: %1 bytes", m_config.max_open_files_size); // Throws
     {
         const char* lead_text = "Encryption";
         if (m_config.encryption_key) {
@@ -5333,7 +5361,11 @@ void ServerImpl::start()
     logger.info("Download compaction: %1",
                 (m_config.disable_download_compaction ? "No" : "Yes")); // Throws
     logger.info("Download bootstrap caching: %1",
-                (m_config.enable_download_bootstrap_cache ? "Yes" : "No"));                // Throws
+                (m_config.enable_download_bootstrap_cache ? "Yes" : "No")); // Throws
+    if (m_config.enable_download_bootstrap_cache) {
+        logger.info("Download bootstrap cache max lag: %1 versions",
+                    m_config.download_bootstrap_cache_max_lag); // Throws
+    }
     logger.info("Max download size: %1 bytes", m_config.max_download_size);                // Throws
     logger.info("Max upload backlog: %1 bytes", m_max_upload_backlog);                     // Throws
     logger.info("HTTP request timeout: %1 ms", m_config.http_request_timeout);             // Throws
@@ -5888,6 +5920,8 @@ void ServerImpl::handle_allocation_metrics_wait()
     reporter.gauge("memory,subsystem=decrypted", double(decr_mem.memory_size));
     reporter.gauge("memory,subsystem=reclaimer_workload", double(decr_mem.reclaimer_workload));
     reporter.gauge("memory,subsystem=reclaimer_target", double(decr_mem.reclaimer_target));
+    reporter.gauge("memory,subsystem=decryption_read_ahead", double(decr_mem.read_ahead_size));
+    reporter.gauge("memory,subsystem=reclaimed", double(decr_mem.reclaimed_size));
     reporter.gauge("memory,subsystem=core-slab", double(SlabAlloc::get_total_slab_size()));
     initiate_allocation_metrics_wait();
 }
@@ -86,6 +86,14 @@ public:
         /// for each major thread).
         long max_open_files = 256;
 
+        /// The maximum accumulated size in bytes of the Realm files that will
+        /// be kept open concurrently by each major thread inside the server
+        /// (see `max_open_files`). This allows the server to keep many small
+        /// files open, while bounding the amount of memory mapped on behalf of
+        /// large files. The most recently accessed file is always kept open,
+        /// regardless of its size. Zero means no limit.
+        std::uint_fast64_t max_open_files_size = 0;
+
         /// An optional custom clock to be used for token expiration checks. If
         /// no clock is specified, the server will use the system clock.
         Clock* token_expiration_clock = nullptr;
@@ -187,6 +195,16 @@ public:
         /// message(s) used for client bootstrapping.
         bool enable_download_bootstrap_cache = false;
 
+        /// The maximum number of server versions by which a cached bootstrap
+        /// DOWNLOAD body is allowed to lag behind the latest server version
+        /// while still being served to new clients. The changesets produced
+        /// after the cached body was built are then sent to the client in
+        /// subsequent DOWNLOAD messages. When the lag exceeds this limit, the
+        /// cached body is rebuilt. Zero means that the cached body is only
+        /// used when it is fully up to date. This has no effect unless
+        /// `enable_download_bootstrap_cache` is true.
+        version_type download_bootstrap_cache_max_lag = 1024;
+
         /// The accumulated size of changesets that are included in download
         /// messages. The size of the changesets is calculated before log
         /// compaction (if enabled). A larger value leads to more efficient
@@ -107,6 +107,7 @@ int main(int argc, char* argv[])
         config_2.ssl_certificate_key_path = config.ssl_certificate_key_path;
         config_2.disable_download_compaction = config.disable_download_compaction;
         config_2.enable_download_bootstrap_cache = config.enable_download_bootstrap_cache;
+        config_2.download_bootstrap_cache_max_lag = config.download_bootstrap_cache_max_lag;
         config_2.max_download_size = config.max_download_size;
         config_2.listen_backlog = config.listen_backlog;
         config_2.tcp_no_delay = config.tcp_no_delay;
@@ -57,6 +57,7 @@ void parse_arguments(int argc, char* argv[], Configuration& configuration)
         {"encryption-key",                       required_argument, nullptr, 'e'},
         {"max-upload-backlog",                   required_argument, nullptr, 'U'},
         {"enable-download-bootstrap-cache",      no_argument,       nullptr, 'B'},
+        {"download-bootstrap-cache-max-lag",     required_argument, nullptr, 'Z'},
         {"disable-sync-to-disk",                 no_argument,       nullptr, 'A'},
         {"max-protocol-version",                 required_argument, nullptr, 'o'},
         {"disable-serial-transacts",             no_argument,       nullptr, 'c'},
@@ -67,7 +68,7 @@ void parse_arguments(int argc, char* argv[], Configuration& configuration)
         // clang-format on
     };
 
-    static const char* opt_desc = "r:L:p:J:M:i:d:N:l:YPk:m:hnsC:K:b:DSu:t:f:H:I:qe:jRGEa:g:U:BA12:v:x:o:cOQF:";
+    static const char* opt_desc = "r:L:p:J:M:i:d:N:l:YPk:m:hnsC:K:b:DSu:t:f:H:I:qe:jRGEa:g:U:BZ:A12:v:x:o:cOQF:";
 
     int opt_index = 0;
     int opt;
@@ -308,6 +309,20 @@ void parse_arguments(int argc, char* argv[], Configuration& configuration)
             case 'B':
                 configuration.enable_download_bootstrap_cache = true;
                 break;
+            case 'Z': {
+                std::istringstream in(optarg);
+                in.unsetf(std::ios_base::skipws);
+                sync::version_type v = 0;
+                in >> v;
+                if (in && in.eof()) {
+                    configuration.download_bootstrap_cache_max_lag = v;
+                }
+                else {
+                    std::cerr << "Error: Invalid download bootstrap cache max lag `" << optarg << "'.\n\n";
+                    show_help(argv[0]);
+                    std::exit(EXIT_FAILURE);
+                }
+            } break;
             case 'A':
                 configuration.disable_sync_to_disk = true;
                 break;
@@ -711,6 +726,9 @@ void show_help(const std::string& program_name)
         "                                 default value will be chosen.\n"
         "  -B, --enable-download-bootstrap-cache  Makes the server cache the contents of the\n"
         "                                 DOWNLOAD message(s) used for client bootstrapping.\n"
+        "  -Z, --download-bootstrap-cache-max-lag NUM\n"
+        "                                 See\n"
+        "                                 `sync::Server::Config::download_bootstrap_cache_max_lag`.\n"
         "  -A, --disable-sync-to-disk     Disable sync to disk (msync(), fsync()).\n"
         "  -o, --max-protocol-version     Maximum protocol version to allow during negotiation\n"
         "                                 with clients. Zero means unspecified. Default is zero.\n"
@@ -44,6 +44,7 @@ struct Configuration {
     bool history_compaction_ignore_clients = false;
     bool disable_download_compaction = false;
     bool enable_download_bootstrap_cache = false;
+    sync::version_type download_bootstrap_cache_max_lag = 1024;
     std::size_t max_download_size = 0x1000000; // 16 MB
     int listen_backlog = util::network::Acceptor::max_connections;
     bool tcp_no_delay = false;
@@ -1101,6 +1101,7 @@ void Table::fully_detach() noexcept
     m_opposite_table.detach();
     m_opposite_column.detach();
     m_index_accessors.clear();
+    m_backlink_positions.clear();
 }
 
 
@@ -30,6 +30,7 @@
 #include <realm/util/function_ref.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/table_ref.hpp>
+#include <realm/array_backlink.hpp>
 #include <realm/spec.hpp>
 #include <realm/query.hpp>
 #include <realm/table_cluster_tree.hpp>
@@ -651,6 +652,7 @@ private:
     Array m_opposite_table;                         // 7th slot in m_top
     Array m_opposite_column;                        // 8th slot in m_top
     std::vector<StringIndex*> m_index_accessors;
+    std::map<ColKey, BacklinkPositions> m_backlink_positions; // By backlink column
     ColKey m_primary_key_col;
     Replication* const* m_repl;
     static Replication* g_dummy_replication;
@@ -50,7 +50,10 @@ public:
 
     void set_file_size(off_t new_size);
 
-    bool read(FileDesc fd, off_t pos, char* dst, size_t size);
+    // Reads and decrypts the blocks in the given range of the data, using as
+    // few reads of the file as possible. Stops at the first block which has
+    // not been written yet, and returns the number of bytes decrypted.
+    size_t read(FileDesc fd, off_t pos, char* dst, size_t size);
     void write(FileDesc fd, off_t pos, const char* src, size_t size) noexcept;
 
 private:
@@ -73,16 +76,20 @@ private:
 #elif defined(_WIN32)
     BCRYPT_KEY_HANDLE m_aes_key_handle;
 #else
-    uint8_t m_aesKey[32];
-    EVP_CIPHER_CTX* m_ctx;
+    EVP_CIPHER_CTX* m_encr;
+    EVP_CIPHER_CTX* m_decr;
+    // The hash states after the padded HMAC key
+    SHA256_CTX m_hmac_inner;
+    SHA256_CTX m_hmac_outer;
 #endif
 
     uint8_t m_hmacKey[32];
     std::vector<iv_table> m_iv_buffer;
     std::unique_ptr<char[]> m_rw_buffer;
     std::unique_ptr<char[]> m_dst_buffer;
+    std::unique_ptr<char[]> m_run_buffer; // for reading or writing more than one block at a time
 
-    void calc_hmac(const void* src, size_t len, uint8_t* dst, const uint8_t* key) const;
+    void calc_hmac(const void* src, size_t len, uint8_t* dst) const;
     bool check_hmac(const void* data, size_t len, const uint8_t* hmac) const;
     void crypt(EncryptionMode mode, off_t pos, char* dst, const char* src, const char* stored_iv) noexcept;
     iv_table& get_iv_table(FileDesc fd, off_t data_pos) noexcept;
@@ -101,6 +108,7 @@ struct SharedFileInfo {
     uint64_t last_scanned_version = 0;
     uint64_t current_version = 0;
     size_t num_decrypted_pages = 0;
+    size_t num_read_ahead_pages = 0;
     size_t num_reclaimed_pages = 0;
     size_t progress_index = 0;
     std::vector<ReaderInfo> readers;
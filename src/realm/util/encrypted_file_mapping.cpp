@@ -31,6 +31,7 @@
 #include <iostream>
 #endif
 
+#include <climits>
 #include <cstring>
 
 #if defined(_WIN32)
@@ -93,6 +94,9 @@ const size_t block_size = 4096;
 const size_t metadata_size = sizeof(iv_table);
 const size_t blocks_per_metadata_block = block_size / metadata_size;
 
+// the most blocks read from or written to the file at a time
+const size_t max_run_blocks = 16;
+
 // map an offset in the data to the actual location in the file
 template <typename Int>
 Int real_offset(Int pos)
@@ -125,19 +129,59 @@ off_t iv_table_pos(off_t pos)
 
 void check_write(FileDesc fd, off_t pos, const void* data, size_t len)
 {
+#ifdef _WIN32
     uint64_t orig = File::get_file_pos(fd);
     File::seek_static(fd, pos);
     File::write_static(fd, static_cast<const char*>(data), len);
     File::seek_static(fd, orig);
+#else
+    // A positional write takes a single system call and leaves the file position alone
+    const char* src = static_cast<const char*>(data);
+    while (0 < len) {
+        size_t n = std::min(len, size_t(SSIZE_MAX));
+        ssize_t r = ::pwrite(fd, src, n, pos);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::system_category(), "pwrite() failed");
+        }
+        REALM_ASSERT_RELEASE(size_t(r) <= n);
+        len -= size_t(r);
+        src += size_t(r);
+        pos += off_t(r);
+    }
+#endif
 }
 
 size_t check_read(FileDesc fd, off_t pos, void* dst, size_t len)
 {
+#ifdef _WIN32
     uint64_t orig = File::get_file_pos(fd);
     File::seek_static(fd, pos);
     size_t ret = File::read_static(fd, static_cast<char*>(dst), len);
     File::seek_static(fd, orig);
     return ret;
+#else
+    // A positional read takes a single system call and leaves the file position alone
+    char* data = static_cast<char*>(dst);
+    char* const data_0 = data;
+    while (0 < len) {
+        size_t n = std::min(len, size_t(SSIZE_MAX));
+        ssize_t r = ::pread(fd, data, n, pos);
+        if (r == 0)
+            break;
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::system_category(), "pread() failed");
+        }
+        REALM_ASSERT_RELEASE(size_t(r) <= n);
+        len -= size_t(r);
+        data += size_t(r);
+        pos += off_t(r);
+    }
+    return data - data_0;
+#endif
 }
 
 } // anonymous namespace
@@ -168,14 +212,41 @@ AESCryptor::AESCryptor(const uint8_t* key)
     ret = BCryptGenerateSymmetricKey(hAesAlg, &m_aes_key_handle, nullptr, 0, (PBYTE)key, 32, 0);
     REALM_ASSERT_RELEASE_EX(ret == 0 && "BCryptGenerateSymmetricKey()", ret);
 #else
-    m_ctx = EVP_CIPHER_CTX_new();
+    m_encr = EVP_CIPHER_CTX_new();
+    m_decr = EVP_CIPHER_CTX_new();
 
-    if (!m_ctx)
+    if (!m_encr || !m_decr)
         handle_error();
 
-    memcpy(m_aesKey, key, 32);
+    // The key is expanded once here, and crypt() only sets the IV of each block
+    if (!EVP_CipherInit_ex(m_encr, EVP_aes_256_cbc(), NULL, key, NULL, mode_Encrypt) ||
+        !EVP_CipherInit_ex(m_decr, EVP_aes_256_cbc(), NULL, key, NULL, mode_Decrypt))
+        handle_error();
+
+    // Use zero padding - we always write a whole page
+    EVP_CIPHER_CTX_set_padding(m_encr, 0);
+    EVP_CIPHER_CTX_set_padding(m_decr, 0);
 #endif
     memcpy(m_hmacKey, key + 32, 32);
+
+#if !REALM_PLATFORM_APPLE && !defined(_WIN32)
+    // The padded HMAC key makes up the first block of both the inner and the
+    // outer hash, so hash it once here and start every HMAC from the result
+    uint8_t ipad[64];
+    for (size_t i = 0; i < 32; ++i)
+        ipad[i] = m_hmacKey[i] ^ 0x36;
+    memset(ipad + 32, 0x36, 32);
+
+    uint8_t opad[64] = {0};
+    for (size_t i = 0; i < 32; ++i)
+        opad[i] = m_hmacKey[i] ^ 0x5C;
+    memset(opad + 32, 0x5C, 32);
+
+    SHA224_Init(&m_hmac_inner);
+    SHA256_Update(&m_hmac_inner, ipad, 64);
+    SHA224_Init(&m_hmac_outer);
+    SHA256_Update(&m_hmac_outer, opad, 64);
+#endif
 }
 
 AESCryptor::~AESCryptor() noexcept
@@ -185,8 +256,8 @@ AESCryptor::~AESCryptor() noexcept
     CCCryptorRelease(m_decr);
 #elif defined(_WIN32)
 #else
-    EVP_CIPHER_CTX_cleanup(m_ctx);
-    EVP_CIPHER_CTX_free(m_ctx);
+    EVP_CIPHER_CTX_free(m_encr);
+    EVP_CIPHER_CTX_free(m_decr);
 #endif
 }
 
@@ -228,7 +299,7 @@ iv_table& AESCryptor::get_iv_table(FileDesc fd, off_t data_pos) noexcept
 bool AESCryptor::check_hmac(const void* src, size_t len, const uint8_t* hmac) const
 {
     uint8_t buffer[224 / 8];
-    calc_hmac(src, len, buffer, m_hmacKey);
+    calc_hmac(src, len, buffer);
 
     // Constant-time memcmp to avoid timing attacks
     uint8_t result = 0;
@@ -237,98 +308,139 @@ bool AESCryptor::check_hmac(const void* src, size_t len, const uint8_t* hmac) co
     return result == 0;
 }
 
-bool AESCryptor::read(FileDesc fd, off_t pos, char* dst, size_t size)
+size_t AESCryptor::read(FileDesc fd, off_t pos, char* dst, size_t size)
 {
     REALM_ASSERT(size % block_size == 0);
+    size_t bytes_decrypted = 0;
     while (size > 0) {
-        ssize_t bytes_read = check_read(fd, real_offset(pos), m_rw_buffer.get(), block_size);
-
-        if (bytes_read == 0)
-            return false;
-
-        iv_table& iv = get_iv_table(fd, pos);
-        if (iv.iv1 == 0) {
-            // This block has never been written to, so we've just read pre-allocated
-            // space. No memset() since the code using this doesn't rely on
-            // pre-allocated space being zeroed.
-            return false;
+        // The data blocks are contiguous in the file up to the next metadata
+        // block, so read all of those needed with a single read
+        size_t block_ndx = size_t(pos) / block_size;
+        size_t num_blocks = std::min({size / block_size, max_run_blocks,
+                                      blocks_per_metadata_block - block_ndx % blocks_per_metadata_block});
+        char* buffer = m_rw_buffer.get();
+        if (num_blocks > 1) {
+            if (!m_run_buffer)
+                m_run_buffer.reset(new char[max_run_blocks * block_size]);
+            buffer = m_run_buffer.get();
         }
-
-        if (!check_hmac(m_rw_buffer.get(), bytes_read, iv.hmac1)) {
-            // Either the DB is corrupted or we were interrupted between writing the
-            // new IV and writing the data
-            if (iv.iv2 == 0) {
-                // Very first write was interrupted
-                return false;
+        size_t bytes_read = check_read(fd, real_offset(pos), buffer, num_blocks * block_size);
+
+        for (size_t i = 0; i < num_blocks; ++i) {
+            char* src = buffer + i * block_size;
+            size_t block_bytes = bytes_read > i * block_size ? std::min(bytes_read - i * block_size, block_size) : 0;
+            if (block_bytes == 0)
+                return bytes_decrypted;
+
+            iv_table& iv = get_iv_table(fd, pos);
+            if (iv.iv1 == 0) {
+                // This block has never been written to, so we've just read pre-allocated
+                // space. No memset() since the code using this doesn't rely on
+                // pre-allocated space being zeroed.
+                return bytes_decrypted;
             }
 
-            if (check_hmac(m_rw_buffer.get(), bytes_read, iv.hmac2)) {
-                // Un-bump the IV since the write with the bumped IV never actually
-                // happened
-                memcpy(&iv.iv1, &iv.iv2, 32);
-            }
-            else {
-                // If the file has been shrunk and then re-expanded, we may have
-                // old hmacs that don't go with this data. ftruncate() is
-                // required to fill any added space with zeroes, so assume that's
-                // what happened if the buffer is all zeroes
-                for (ssize_t i = 0; i < bytes_read; ++i) {
-                    if (m_rw_buffer[i] != 0)
-                        throw DecryptionFailed();
+            if (!check_hmac(src, block_bytes, iv.hmac1)) {
+                // Either the DB is corrupted or we were interrupted between writing the
+                // new IV and writing the data
+                if (iv.iv2 == 0) {
+                    // Very first write was interrupted
+                    return bytes_decrypted;
+                }
+
+                if (check_hmac(src, block_bytes, iv.hmac2)) {
+                    // Un-bump the IV since the write with the bumped IV never actually
+                    // happened
+                    memcpy(&iv.iv1, &iv.iv2, 32);
+                }
+                else {
+                    // If the file has been shrunk and then re-expanded, we may have
+                    // old hmacs that don't go with this data. ftruncate() is
+                    // required to fill any added space with zeroes, so assume that's
+                    // what happened if the buffer is all zeroes
+                    for (size_t j = 0; j < block_bytes; ++j) {
+                        if (src[j] != 0)
+                            throw DecryptionFailed();
+                    }
+                    return bytes_decrypted;
                 }
-                return false;
             }
-        }
 
-        // We may expect some adress ranges of the destination buffer of
-        // AESCryptor::read() to stay unmodified, i.e. being overwritten with
-        // the same bytes as already present, and may have read-access to these
-        // from other threads while decryption is taking place.
-        //
-        // However, some implementations of AES_cbc_encrypt(), in particular
-        // OpenSSL, will put garbled bytes as an intermediate step during the
-        // operation which will lead to incorrect data being read by other
-        // readers concurrently accessing that page. Incorrect data leads to
-        // crashes.
-        //
-        // We therefore decrypt to a temporary buffer first and then copy the
-        // completely decrypted data after.
-        crypt(mode_Decrypt, pos, m_dst_buffer.get(), m_rw_buffer.get(), reinterpret_cast<const char*>(&iv.iv1));
-        memcpy(dst, m_dst_buffer.get(), block_size);
-
-        pos += block_size;
-        dst += block_size;
-        size -= block_size;
+            // We may expect some adress ranges of the destination buffer of
+            // AESCryptor::read() to stay unmodified, i.e. being overwritten with
+            // the same bytes as already present, and may have read-access to these
+            // from other threads while decryption is taking place.
+            //
+            // However, some implementations of AES_cbc_encrypt(), in particular
+            // OpenSSL, will put garbled bytes as an intermediate step during the
+            // operation which will lead to incorrect data being read by other
+            // readers concurrently accessing that page. Incorrect data leads to
+            // crashes.
+            //
+            // We therefore decrypt to a temporary buffer first and then copy the
+            // completely decrypted data after.
+            crypt(mode_Decrypt, pos, m_dst_buffer.get(), src, reinterpret_cast<const char*>(&iv.iv1));
+            memcpy(dst, m_dst_buffer.get(), block_size);
+
+            pos += block_size;
+            dst += block_size;
+            size -= block_size;
+            bytes_decrypted += block_size;
+        }
     }
-    return true;
+    return bytes_decrypted;
 }
 
 void AESCryptor::write(FileDesc fd, off_t pos, const char* src, size_t size) noexcept
 {
     REALM_ASSERT(size % block_size == 0);
     while (size > 0) {
-        iv_table& iv = get_iv_table(fd, pos);
+        // The IV table entries of the blocks up to the next metadata block are
+        // contiguous in the file, and so are their data blocks. Encrypt all of
+        // those blocks first, and then write all of their IVs with one write
+        // followed by all of their data with another.
+        size_t block_ndx = size_t(pos) / block_size;
+        size_t num_blocks = std::min({size / block_size, max_run_blocks,
+                                      blocks_per_metadata_block - block_ndx % blocks_per_metadata_block});
+        char* buffer = m_rw_buffer.get();
+        if (num_blocks > 1) {
+            // Fall back to writing one block at a time if there's no memory for more
+            if (!m_run_buffer)
+                m_run_buffer.reset(new (std::nothrow) char[max_run_blocks * block_size]);
+            if (m_run_buffer)
+                buffer = m_run_buffer.get();
+            else
+                num_blocks = 1;
+        }
 
-        memcpy(&iv.iv2, &iv.iv1, 32);
-        do {
-            ++iv.iv1;
-            // 0 is reserved for never-been-used, so bump if we just wrapped around
-            if (iv.iv1 == 0)
-                ++iv.iv1;
+        iv_table* first_iv = &get_iv_table(fd, pos);
+        for (size_t i = 0; i < num_blocks; ++i) {
+            off_t block_pos = pos + off_t(i * block_size);
+            iv_table& iv = get_iv_table(fd, block_pos);
+            REALM_ASSERT(&iv == first_iv + i);
+            char* dst = buffer + i * block_size;
 
-            crypt(mode_Encrypt, pos, m_rw_buffer.get(), src, reinterpret_cast<const char*>(&iv.iv1));
-            calc_hmac(m_rw_buffer.get(), block_size, iv.hmac1, m_hmacKey);
-            // In the extremely unlikely case that both the old and new versions have
-            // the same hash we won't know which IV to use, so bump the IV until
-            // they're different.
-        } while (REALM_UNLIKELY(memcmp(iv.hmac1, iv.hmac2, 4) == 0));
+            memcpy(&iv.iv2, &iv.iv1, 32);
+            do {
+                ++iv.iv1;
+                // 0 is reserved for never-been-used, so bump if we just wrapped around
+                if (iv.iv1 == 0)
+                    ++iv.iv1;
+
+                crypt(mode_Encrypt, block_pos, dst, src + i * block_size, reinterpret_cast<const char*>(&iv.iv1));
+                calc_hmac(dst, block_size, iv.hmac1);
+                // In the extremely unlikely case that both the old and new versions have
+                // the same hash we won't know which IV to use, so bump the IV until
+                // they're different.
+            } while (REALM_UNLIKELY(memcmp(iv.hmac1, iv.hmac2, 4) == 0));
+        }
 
-        check_write(fd, iv_table_pos(pos), &iv, sizeof(iv));
-        check_write(fd, real_offset(pos), m_rw_buffer.get(), block_size);
+        check_write(fd, iv_table_pos(pos), first_iv, num_blocks * sizeof(iv_table));
+        check_write(fd, real_offset(pos), buffer, num_blocks * block_size);
 
-        pos += block_size;
-        src += block_size;
-        size -= block_size;
+        pos += num_blocks * block_size;
+        src += num_blocks * block_size;
+        size -= num_blocks * block_size;
     }
 }
 
@@ -367,28 +479,28 @@ void AESCryptor::crypt(EncryptionMode mode, off_t pos, char* dst, const char* sr
     }
 
 #else
-    if (!EVP_CipherInit_ex(m_ctx, EVP_aes_256_cbc(), NULL, m_aesKey, iv, mode))
+    EVP_CIPHER_CTX* ctx = mode == mode_Encrypt ? m_encr : m_decr;
+    // Passing no cipher and no key keeps the expanded key and only sets the IV
+    if (!EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, -1))
         handle_error();
 
     int len;
-    // Use zero padding - we always write a whole page
-    EVP_CIPHER_CTX_set_padding(m_ctx, 0);
-
-    if (!EVP_CipherUpdate(m_ctx, reinterpret_cast<uint8_t*>(dst), &len, reinterpret_cast<const uint8_t*>(src),
+    if (!EVP_CipherUpdate(ctx, reinterpret_cast<uint8_t*>(dst), &len, reinterpret_cast<const uint8_t*>(src),
                           block_size))
         handle_error();
 
     // Finalize the encryption. Should not output further data.
-    if (!EVP_CipherFinal_ex(m_ctx, reinterpret_cast<uint8_t*>(dst) + len, &len))
+    if (!EVP_CipherFinal_ex(ctx, reinterpret_cast<uint8_t*>(dst) + len, &len))
         handle_error();
 #endif
 }
 
-void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst, const uint8_t* key) const
+void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst) const
 {
 #if REALM_PLATFORM_APPLE
-    CCHmac(kCCHmacAlgSHA224, key, 32, src, len, dst);
-#else
+    CCHmac(kCCHmacAlgSHA224, m_hmacKey, 32, src, len, dst);
+#elif defined(_WIN32)
+    const uint8_t* key = m_hmacKey;
     uint8_t ipad[64];
     for (size_t i = 0; i < 32; ++i)
         ipad[i] = key[i] ^ 0x36;
@@ -400,7 +512,6 @@ void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst, const uint
     memset(opad + 32, 0x5C, 32);
 
     // Full hmac operation is sha224(opad + sha224(ipad + data))
-#ifdef _WIN32
     sha224_state s;
     sha_init(s);
     sha_process(s, ipad, 64);
@@ -412,19 +523,16 @@ void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst, const uint
     sha_process(s, dst, 28); // 28 == SHA224_DIGEST_LENGTH
     sha_done(s, dst);
 #else
-    SHA256_CTX ctx;
-    SHA224_Init(&ctx);
-    SHA256_Update(&ctx, ipad, 64);
+    // Full hmac operation is sha224(opad + sha224(ipad + data)), where the
+    // hashes of the pads are precomputed
+    SHA256_CTX ctx = m_hmac_inner;
     SHA256_Update(&ctx, static_cast<const uint8_t*>(src), len);
     SHA256_Final(dst, &ctx);
 
-    SHA224_Init(&ctx);
-    SHA256_Update(&ctx, opad, 64);
+    ctx = m_hmac_outer;
     SHA256_Update(&ctx, dst, SHA224_DIGEST_LENGTH);
     SHA256_Final(dst, &ctx);
 #endif
-
-#endif
 }
 
 EncryptedFileMapping::EncryptedFileMapping(SharedFileInfo& file, size_t file_offset, void* addr, size_t size,
@@ -498,6 +606,17 @@ bool EncryptedFileMapping::copy_up_to_date_page(size_t local_page_ndx) noexcept
     return false;
 }
 
+bool EncryptedFileMapping::is_decrypted_elsewhere(size_t page_ndx_in_file) const noexcept
+{
+    for (size_t i = 0; i < m_file.mappings.size(); ++i) {
+        EncryptedFileMapping* m = m_file.mappings[i];
+        if (m != this && m->contains_page(page_ndx_in_file) &&
+            m->m_page_state[page_ndx_in_file - m->m_first_page] != PageState(0))
+            return true;
+    }
+    return false;
+}
+
 void EncryptedFileMapping::refresh_page(size_t local_page_ndx)
 {
     REALM_ASSERT_EX(local_page_ndx < m_page_state.size(), local_page_ndx, m_page_state.size());
@@ -505,9 +624,36 @@ void EncryptedFileMapping::refresh_page(size_t local_page_ndx)
     char* addr = page_addr(local_page_ndx);
 
     if (!copy_up_to_date_page(local_page_ndx)) {
+        // Pages which are read from the file one after another are assumed to
+        // be part of a sequential scan, and the following pages are then read
+        // and decrypted along with the requested one. The read-ahead doubles
+        // for every further page in sequence, up to max_read_ahead_pages.
+        if (m_last_read_page != size_t(-1) && local_page_ndx == m_last_read_page + 1)
+            m_read_ahead_pages = std::min(std::max(m_read_ahead_pages * 2, size_t(1)), max_read_ahead_pages);
+        else
+            m_read_ahead_pages = 0;
+
+        // Only pages which have never been decrypted, or have been reclaimed,
+        // are read ahead, as the others may have changes which are not on file
+        // yet or may be in use by readers of older versions
         size_t page_ndx_in_file = local_page_ndx + m_first_page;
-        m_file.cryptor.read(m_file.fd, off_t(page_ndx_in_file << m_page_shift),
-                            addr, static_cast<size_t>(1ULL << m_page_shift));
+        size_t num_pages = 1;
+        while (num_pages <= m_read_ahead_pages && local_page_ndx + num_pages < m_page_state.size() &&
+               m_page_state[local_page_ndx + num_pages] == PageState(0) &&
+               !is_decrypted_elsewhere(page_ndx_in_file + num_pages))
+            ++num_pages;
+
+        size_t bytes_decrypted = m_file.cryptor.read(m_file.fd, off_t(page_ndx_in_file << m_page_shift), addr,
+                                                     num_pages << m_page_shift);
+
+        // A page read ahead is only valid if all of it could be decrypted
+        size_t pages_decrypted = bytes_decrypted >> m_page_shift;
+        for (size_t i = 1; i < num_pages && i < pages_decrypted; ++i) {
+            set(m_page_state[local_page_ndx + i], UpToDate);
+            m_num_decrypted++;
+            m_num_read_ahead++;
+        }
+        m_last_read_page = local_page_ndx + std::max(std::min(num_pages, pages_decrypted), size_t(1)) - 1;
     }
     if (is_not(m_page_state[local_page_ndx], UpToDate | PartiallyUpToDate))
         m_num_decrypted++;
@@ -566,9 +712,8 @@ void EncryptedFileMapping::validate_page(size_t local_page_ndx) noexcept
         return;
 
     const size_t page_ndx_in_file = local_page_ndx + m_first_page;
-    if (!m_file.cryptor.read(m_file.fd, off_t(page_ndx_in_file << m_page_shift),
-                             m_validate_buffer.get(),
-                             static_cast<size_t>(1ULL << m_page_shift)))
+    if (m_file.cryptor.read(m_file.fd, off_t(page_ndx_in_file << m_page_shift), m_validate_buffer.get(),
+                            static_cast<size_t>(1ULL << m_page_shift)) < static_cast<size_t>(1ULL << m_page_shift))
         return;
 
     for (size_t i = 0; i < m_file.mappings.size(); ++i) {
@@ -654,6 +799,7 @@ void EncryptedFileMapping::reclaim_untouched(size_t& progress_index, size_t& wor
                 clear(m_page_state[page_ndx], UpToDate | PartiallyUpToDate);
                 reclaim_page(page_ndx);
                 m_num_decrypted--;
+                m_num_reclaimed++;
                 done_some_work();
             }
             contiguous_scan = false;
@@ -713,16 +859,24 @@ void EncryptedFileMapping::reclaim_untouched(size_t& progress_index, size_t& wor
 void EncryptedFileMapping::flush() noexcept
 {
     const size_t num_dirty_pages = m_page_state.size();
-    for (size_t local_page_ndx = 0; local_page_ndx < num_dirty_pages; ++local_page_ndx) {
+    size_t local_page_ndx = 0;
+    while (local_page_ndx < num_dirty_pages) {
         if (is_not(m_page_state[local_page_ndx], Dirty)) {
             validate_page(local_page_ndx);
+            ++local_page_ndx;
             continue;
         }
 
+        // Write each run of dirty pages with a single call, so that the
+        // cryptor can combine the writes of neighbouring blocks
+        size_t end = local_page_ndx + 1;
+        while (end < num_dirty_pages && is(m_page_state[end], Dirty))
+            ++end;
         size_t page_ndx_in_file = local_page_ndx + m_first_page;
         m_file.cryptor.write(m_file.fd, off_t(page_ndx_in_file << m_page_shift), page_addr(local_page_ndx),
-                             static_cast<size_t>(1ULL << m_page_shift));
-        clear(m_page_state[local_page_ndx], Dirty);
+                             (end - local_page_ndx) << m_page_shift);
+        for (; local_page_ndx < end; ++local_page_ndx)
+            clear(m_page_state[local_page_ndx], Dirty);
     }
 
     validate();
@@ -849,6 +1003,8 @@ void EncryptedFileMapping::set(void* new_addr, size_t new_size, size_t new_file_
     size_t num_pages = new_size >> m_page_shift;
 
     m_num_decrypted = 0;
+    m_last_read_page = size_t(-1);
+    m_read_ahead_pages = 0;
     m_page_state.clear();
     m_chunk_dont_scan.clear();
 
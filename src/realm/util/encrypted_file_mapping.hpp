@@ -68,6 +68,20 @@ public:
     {
         return m_num_decrypted;
     }
+    // Number of pages decrypted ahead of being accessed since the last call
+    size_t collect_read_ahead_count()
+    {
+        size_t count = m_num_read_ahead;
+        m_num_read_ahead = 0;
+        return count;
+    }
+    // Number of pages reclaimed since the last call
+    size_t collect_reclaim_count()
+    {
+        size_t count = m_num_reclaimed;
+        m_num_reclaimed = 0;
+        return count;
+    }
     // reclaim any untouched pages - this is thread safe with respect to
     // concurrent access/touching of pages - but must be called with the mutex locked.
     void reclaim_untouched(size_t& progress_ptr, size_t& accumulated_savings) noexcept;
@@ -94,6 +108,16 @@ private:
 
     size_t m_first_page;
     size_t m_num_decrypted; // 1 for every page decrypted
+    size_t m_num_read_ahead = 0; // 1 for every page decrypted ahead of being accessed
+    size_t m_num_reclaimed = 0;  // 1 for every page reclaimed
+
+    // The last page read from the file, and the number of pages to read ahead
+    // of the next one if it follows that
+    size_t m_last_read_page = size_t(-1);
+    size_t m_read_ahead_pages = 0;
+    // With 4 KiB pages, the requested page and the pages read ahead of it fit
+    // in a single read by the cryptor
+    static constexpr size_t max_read_ahead_pages = 15;
 
     enum PageState {
         Touched = 1,           // a ref->ptr translation has taken place
@@ -134,6 +158,7 @@ private:
 
     void mark_outdated(size_t local_page_ndx) noexcept;
     bool copy_up_to_date_page(size_t local_page_ndx) noexcept;
+    bool is_decrypted_elsewhere(size_t page_ndx_in_file) const noexcept;
     void refresh_page(size_t local_page_ndx);
     void write_page(size_t local_page_ndx) noexcept;
     void write_and_update_all(size_t local_page_ndx, size_t begin_offset, size_t end_offset) noexcept;
@@ -1248,6 +1248,61 @@ void File::sync_map(FileDesc fd, void* addr, size_t size)
 }
 
 
+void File::advise(AccessHint hint, size_t offset, size_t size) const noexcept
+{
+    REALM_ASSERT_DEBUG(is_attached());
+#ifdef POSIX_FADV_NORMAL
+    int advice = POSIX_FADV_NORMAL;
+    switch (hint) {
+        case hint_Normal:
+            break;
+        case hint_Sequential:
+            advice = POSIX_FADV_SEQUENTIAL;
+            break;
+        case hint_Random:
+            advice = POSIX_FADV_RANDOM;
+            break;
+        case hint_WillNeed:
+            advice = POSIX_FADV_WILLNEED;
+            break;
+    }
+    ::posix_fadvise(m_fd, off_t(offset), off_t(size), advice); // Ignore failure
+#else
+    static_cast<void>(hint);
+    static_cast<void>(offset);
+    static_cast<void>(size);
+#endif
+}
+
+
+void File::advise_map(void* addr, size_t size, AccessHint hint) noexcept
+{
+#ifndef _WIN32
+    int advice = MADV_NORMAL;
+    switch (hint) {
+        case hint_Normal:
+            break;
+        case hint_Sequential:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case hint_Random:
+            advice = MADV_RANDOM;
+            break;
+        case hint_WillNeed:
+            advice = MADV_WILLNEED;
+            break;
+    }
+    // madvise() requires a page aligned address
+    size_t misalignment = reinterpret_cast<uintptr_t>(addr) & (page_size() - 1);
+    ::madvise(static_cast<char*>(addr) - misalignment, size + misalignment, advice); // Ignore failure
+#else
+    static_cast<void>(addr);
+    static_cast<void>(size);
+    static_cast<void>(hint);
+#endif
+}
+
+
 bool File::exists(const std::string& path)
 {
 #ifdef _WIN32
@@ -1580,6 +1635,17 @@ void File::MapBase::map(const File& f, AccessMode a, size_t size, int map_flags,
     m_size = size;
     m_fd = f.m_fd;
     m_offset = offset;
+
+    if ((map_flags & map_Populate) && !get_encrypted_mapping()) {
+#ifdef MADV_POPULATE_READ
+        // This has the same effect as MAP_POPULATE would have had. Kernels
+        // older than Linux 5.14 reject it, in which case the pages are read in
+        // asynchronously instead.
+        if (::madvise(m_addr, m_size, MADV_POPULATE_READ) == 0)
+            return;
+#endif
+        File::advise_map(m_addr, m_size, hint_WillNeed);
+    }
 }
 
 
@@ -1610,6 +1676,15 @@ void File::MapBase::sync()
     File::sync_map(m_fd, m_addr, m_size);
 }
 
+void File::MapBase::advise(AccessHint hint, size_t offset, size_t size) noexcept
+{
+    REALM_ASSERT(m_addr);
+    if (get_encrypted_mapping() || offset >= m_size)
+        return;
+
+    File::advise_map(static_cast<char*>(m_addr) + offset, std::min(size, m_size - offset), hint);
+}
+
 
 
 #ifndef _WIN32
@@ -379,9 +379,30 @@ public:
         /// the default behavior. An explicit call to sync_map() will
         /// flush the buffers regardless of whether this flag is
         /// specified or not.
-        map_NoSync = 1
+        map_NoSync = 1,
+        /// Read in the contents of the mapped range when the mapping is
+        /// established, instead of page by page as it is accessed. Has no
+        /// effect for encrypted files, or where not supported by the system.
+        map_Populate = 2
     };
 
+    /// Hints about how a range of a file, or of a memory mapping of it, is
+    /// going to be accessed. They are passed on to the system with
+    /// posix_fadvise() and madvise() respectively, where available.
+    enum AccessHint {
+        hint_Normal,     ///< No particular access pattern
+        hint_Sequential, ///< Read ahead aggressively
+        hint_Random,     ///< Do not read ahead
+        hint_WillNeed    ///< Start reading in the range now
+    };
+
+    /// Advise the system about how the specified range of this file is going
+    /// to be accessed. A size of zero means to the end of the file. The advice
+    /// refers to the raw file, so for encrypted files it is only meaningful
+    /// for the file as a whole. Failures are ignored, as the advice does not
+    /// change the behaviour of any file operation.
+    void advise(AccessHint, size_t offset = 0, size_t size = 0) const noexcept;
+
     /// Map this file into memory. The file is mapped as shared
     /// memory. This allows two processes to interact under exatly the
     /// same rules as applies to the interaction via regular memory of
@@ -436,6 +457,13 @@ public:
     /// map().
     static void sync_map(FileDesc fd, void* addr, size_t size);
 
+    /// Advise the system about how the specified address range, which must
+    /// be (a subset of) one that was previously returned by map(), is going
+    /// to be accessed. The range is extended to page boundaries. Failures are
+    /// ignored. Must not be used for encrypted mappings, as their memory does
+    /// not reflect the file.
+    static void advise_map(void* addr, size_t size, AccessHint) noexcept;
+
     /// Check whether the specified file or directory exists. Note
     /// that a file or directory that resides in a directory that the
     /// calling process has no access to, will necessarily be reported
@@ -645,6 +673,7 @@ private:
         void remap(const File&, AccessMode, size_t size, int map_flags);
         void unmap() noexcept;
         void sync();
+        void advise(AccessHint, size_t offset, size_t size) noexcept;
 #if REALM_ENABLE_ENCRYPTION
         mutable util::EncryptedFileMapping* m_encrypted_mapping = nullptr;
         inline util::EncryptedFileMapping* get_encrypted_mapping() const
@@ -785,6 +814,14 @@ public:
     /// attached to a memory mapped file, has undefined behavior.
     void sync();
 
+    /// See File::advise_map(). The range is given relative to the start of
+    /// the mapping, and is clamped to its size. Has no effect for encrypted
+    /// files, whose pages are read in and decrypted by the encryption layer.
+    ///
+    /// Calling this function on an instance that is not currently
+    /// attached to a memory mapped file, has undefined behavior.
+    void advise(AccessHint, size_t offset = 0, size_t size = size_t(-1)) noexcept;
+
     /// Check whether this Map instance is currently attached to a
     /// memory mapped file.
     bool is_attached() const noexcept;
@@ -1190,6 +1227,12 @@ inline void File::Map<T>::sync()
     MapBase::sync();
 }
 
+template <class T>
+inline void File::Map<T>::advise(AccessHint hint, size_t offset, size_t size) noexcept
+{
+    MapBase::advise(hint, offset, size);
+}
+
 template <class T>
 inline bool File::Map<T>::is_attached() const noexcept
 {
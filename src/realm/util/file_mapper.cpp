@@ -119,6 +119,9 @@ static unsigned int file_reclaim_index = 0;
 static std::atomic<size_t> num_decrypted_pages(0); // this is for statistical purposes
 static std::atomic<size_t> reclaimer_target(0);    // do.
 static std::atomic<size_t> reclaimer_workload(0);  // do.
+static std::atomic<size_t> num_read_ahead_pages(0); // do.
+static std::atomic<size_t> num_reclaimed_pages(0);  // do.
+static std::atomic<int64_t> decrypted_memory_limit(PageReclaimGovernor::no_match);
 // helpers
 
 int64_t fetch_value_in_file(const std::string& fname, const char* scan_pattern)
@@ -143,6 +146,16 @@ int64_t fetch_value_in_file(const std::string& fname, const char* scan_pattern)
 
 /* Default reclaim governor
  *
+ * The target is derived from the system configuration: The target given in the
+ * file named by the REALM_PAGE_GOVERNOR_CFG environment variable, or else the
+ * lowest of a quarter of the physical memory, a quarter of the cgroup memory
+ * limit and the size of the page cache. It is re-evaluated every 10 runs.
+ *
+ * While other tasks are stalled waiting for memory, as reported by the Linux
+ * pressure stall information (PSI), the target is lowered below the current
+ * load, the more the higher the pressure. When the pressure is gone, the target
+ * is raised again gradually, so that bursts of memory pressure do not make the
+ * reclaimer alternate between releasing and keeping most of the pages.
  */
 
 class DefaultGovernor : public PageReclaimGovernor {
@@ -163,7 +176,7 @@ public:
         return target;
     }
 
-    static int64_t get_target_from_system(std::string cfg_file_name)
+    static int64_t get_target_from_system(const std::string& cfg_file_name)
     {
         int64_t target;
         auto local_spec = fetch_value_in_file(cfg_file_name, "target ([[:digit:]]+)");
@@ -174,31 +187,39 @@ public:
             // no local spec, try to deduce something reasonable from platform info
             auto from_proc = fetch_value_in_file("/proc/meminfo", "MemTotal:[[:space:]]+([[:digit:]]+) kB") * 1024;
             auto from_cgroup = fetch_value_in_file("/sys/fs/cgroup/memory/memory.limit_in_bytes", "^([[:digit:]]+)");
+            auto from_cgroup_v2 = fetch_value_in_file("/sys/fs/cgroup/memory.max", "^([[:digit:]]+)");
             auto cache_use = fetch_value_in_file("/sys/fs/cgroup/memory/memory.stat", "cache ([[:digit:]]+)");
             target = pick_if_valid(from_proc, from_proc / 4);
             target = pick_lowest_valid(target, pick_if_valid(from_cgroup, from_cgroup / 4));
+            target = pick_lowest_valid(target, pick_if_valid(from_cgroup_v2, from_cgroup_v2 / 4));
             target = pick_lowest_valid(target, pick_if_valid(cache_use, cache_use));
         }
         return target;
     }
 
-    std::function<int64_t()> current_target_getter(size_t load) override
+    // The percentage of the last 10 seconds in which some tasks were stalled
+    // waiting for memory
+    static int64_t get_memory_pressure()
     {
-        static_cast<void>(load);
-        if (m_refresh_count > 0) {
-            --m_refresh_count;
-            return std::bind([](int64_t target_copy) { return target_copy; }, m_target);
-        }
-        m_refresh_count = 10;
-     
-        return std::bind(get_target_from_system, m_cfg_file_name);
+        return fetch_value_in_file("/proc/pressure/memory", "some avg10=([[:digit:]]+)");
     }
 
-    void report_target_result(int64_t target) override
+    std::function<int64_t()> current_target_getter(size_t load) override
     {
-        m_target = target;
+        bool refresh = m_refresh_count == 0;
+        m_refresh_count = refresh ? 10 : m_refresh_count - 1;
+        // The getter is run by the reclaimer right after this call, so it is
+        // never run concurrently with any other use of the governor
+        return [this, load, refresh]() {
+            if (refresh)
+                m_system_target = get_target_from_system(m_cfg_file_name);
+            int64_t cap = m_pressure_cap.get_pressure_cap(int64_t(load), get_memory_pressure(), m_system_target);
+            return pick_lowest_valid(m_system_target, cap);
+        };
     }
 
+    void report_target_result(int64_t) override {}
+
     DefaultGovernor()
     {
         auto cfg_name = getenv("REALM_PAGE_GOVERNOR_CFG");
@@ -209,11 +230,32 @@ public:
 
 private:
     std::string m_cfg_file_name;
-    int64_t m_target = 0;
+    int64_t m_system_target = no_match;
+    MemoryPressureCap m_pressure_cap;
     int m_refresh_count = 0;
 };
 
 static DefaultGovernor default_governor;
+} // anonymous namespace
+
+int64_t MemoryPressureCap::get_pressure_cap(int64_t load, int64_t pressure, int64_t system_target)
+{
+    constexpr int64_t no_match = PageReclaimGovernor::no_match;
+    if (pressure != no_match && pressure >= pressure_threshold) {
+        // Aim below the current load, but never lower than half of it at a time
+        int64_t cap = load - load * std::min(pressure, int64_t(50)) / 100;
+        m_cap = DefaultGovernor::pick_lowest_valid(m_cap, cap);
+    }
+    else if (m_cap != no_match) {
+        // Relax by 1/8 per run, until the cap no longer matters
+        m_cap += m_cap / 8 + 1;
+        if (m_cap >= DefaultGovernor::pick_lowest_valid(system_target, 2 * load))
+            m_cap = no_match;
+    }
+    return m_cap;
+}
+
+namespace {
 static PageReclaimGovernor* governor = &default_governor;
 
 void reclaim_pages();
@@ -286,6 +328,18 @@ void set_page_reclaim_governor(PageReclaimGovernor* new_governor)
     ensure_reclaimer_thread_runs();
 }
 
+void set_decrypted_memory_limit(size_t limit)
+{
+    UniqueLock lock(mapping_mutex);
+    decrypted_memory_limit = limit ? int64_t(limit) : PageReclaimGovernor::no_match;
+    ensure_reclaimer_thread_runs();
+}
+
+void reclaim_decrypted_pages()
+{
+    reclaim_pages();
+}
+
 size_t get_num_decrypted_pages()
 {
     return num_decrypted_pages.load();
@@ -297,6 +351,8 @@ decrypted_memory_stats_t get_decrypted_memory_stats()
     retval.memory_size = num_decrypted_pages.load() * page_size();
     retval.reclaimer_target = reclaimer_target.load() * page_size();
     retval.reclaimer_workload = reclaimer_workload.load() * page_size();
+    retval.read_ahead_size = num_read_ahead_pages.load() * page_size();
+    retval.reclaimed_size = num_reclaimed_pages.load() * page_size();
     return retval;
 }
 
@@ -337,6 +393,12 @@ size_t collect_total_workload() // must be called under lock
         info.num_decrypted_pages = 0;
         for (auto it = info.mappings.begin(); it != info.mappings.end(); ++it) {
             info.num_decrypted_pages += (*it)->collect_decryption_count();
+            size_t read_ahead = (*it)->collect_read_ahead_count();
+            info.num_read_ahead_pages += read_ahead;
+            num_read_ahead_pages += read_ahead;
+            size_t reclaimed = (*it)->collect_reclaim_count();
+            info.num_reclaimed_pages += reclaimed;
+            num_reclaimed_pages += reclaimed;
         }
         total += info.num_decrypted_pages;
     }
@@ -434,11 +496,14 @@ void reclaim_pages()
     {
         UniqueLock lock(mapping_mutex);
         reclaimer_workload = 0;
-        reclaimer_target = size_t(target / page_size());
         // Putting the target back into the govenor object will allow the govenor
         // to return a getter producing this value again next time it is called
         governor->report_target_result(target);
 
+        // The limit applies whatever the governor says
+        target = DefaultGovernor::pick_lowest_valid(target, decrypted_memory_limit);
+        reclaimer_target = size_t(target / page_size());
+
         if (target == PageReclaimGovernor::no_match) // temporarily disabled by governor returning no_match
             return;
 
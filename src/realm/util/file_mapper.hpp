@@ -73,6 +73,12 @@ inline void set_page_reclaim_governor_to_default()
     set_page_reclaim_governor(nullptr);
 }
 
+// Set an upper limit for the amount of memory holding decrypted pages across
+// all open files. The page reclaim daemon uses the lower of this limit and the
+// target returned by the governor. A limit of zero means no limit, which is the
+// default.
+void set_decrypted_memory_limit(size_t limit);
+
 // Retrieves the number of in memory decrypted pages, across all open files.
 size_t get_num_decrypted_pages();
 
@@ -80,16 +86,45 @@ size_t get_num_decrypted_pages();
 // - amount of memory used for decrypted pages, across all open files.
 // - current target for the reclaimer (desired number of decrypted pages)
 // - current workload size for the reclaimer, across all open files.
+// - amount of data decrypted ahead of being accessed during sequential reads,
+//   across all files since the process started.
+// - amount of memory released by the reclaimer, across all files since the
+//   process started.
 struct decrypted_memory_stats_t {
     size_t memory_size;
     size_t reclaimer_target;
     size_t reclaimer_workload;
+    size_t read_ahead_size;
+    size_t reclaimed_size;
 };
 
 decrypted_memory_stats_t get_decrypted_memory_stats();
 
 #if REALM_ENABLE_ENCRYPTION
 
+// Limits the amount of memory holding decrypted pages while the system is under
+// memory pressure. The default governor feeds it about once per second.
+class MemoryPressureCap {
+public:
+    // Memory pressure (in percent) below which it is ignored
+    static constexpr int64_t pressure_threshold = 10;
+
+    // Feed with the current load (in bytes), the percentage of recent time in
+    // which some tasks were stalled waiting for memory and the target derived
+    // from the system configuration, and return the resulting limit on the
+    // load. The pressure and the system target may be no_match if unknown.
+    // Returns no_match if the load is not limited.
+    int64_t get_pressure_cap(int64_t load, int64_t pressure, int64_t system_target);
+
+private:
+    int64_t m_cap = PageReclaimGovernor::no_match;
+};
+
+// Run the page reclaimer once, as is otherwise done about once per second in
+// the background. Pages are only released if they have not been accessed since
+// the previous run.
+void reclaim_decrypted_pages();
+
 void encryption_note_reader_start(SharedFileInfo& info, const void* reader_id);
 void encryption_note_reader_end(SharedFileInfo& info, const void* reader_id) noexcept;
 
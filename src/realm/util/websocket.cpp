@@ -173,7 +173,8 @@ void mask_payload(char* masking_key, const char* payload, size_t payload_len, ch
     }
 }
 
-// make_frame() creates a WebSocket frame according to the WebSocket standard.
+// make_frame_header() creates the header of a WebSocket frame according to the
+// WebSocket standard.
 // \param fin indicates whether the frame is the final fragment in a message.
 // Sync clients and servers will only send unfragmented messages, but they must be
 // prepared to receive fragmented messages.
@@ -187,14 +188,15 @@ void mask_payload(char* masking_key, const char* payload, size_t payload_len, ch
 // Sync clients and server will only send the last four, but must be prepared to
 // receive all.
 // \param mask indicates whether the payload of the frame should be masked. Frames
-// are masked if and only if they originate from the client.
-// The payload is located in the buffer \param payload, and has size \param payload_size.
-// \param output is the output buffer. It must be large enough to contain the frame.
-// The frame size can at most be payload_size + 14.
+// are masked if and only if they originate from the client. If the frame is masked,
+// the masking key is the last four bytes of the header.
+// \param payload_size is the size of the payload that follows the header.
+// \param output is the output buffer. It must be large enough to contain the header,
+// which is at most 14 bytes.
 // \param random is used to create a random masking key.
-// The return value is the size of the frame.
-size_t make_frame(bool fin, int opcode, bool mask, const char* payload, size_t payload_size, char* output,
-                  std::mt19937_64& random)
+// The return value is the size of the header.
+size_t make_frame_header(bool fin, int opcode, bool mask, size_t payload_size, char* output,
+                         std::mt19937_64& random)
 {
     int index = 0; // used to keep track of position within the header.
     using uchar = unsigned char;
@@ -227,15 +229,27 @@ size_t make_frame(bool fin, int opcode, bool mask, const char* payload, size_t p
         index = 10;
     }
     if (mask) {
-        char masking_key[4];
         std::uniform_int_distribution<> dis(0, 255);
         for (int i = 0; i < 4; ++i) {
-            masking_key[i] = dis(random);
+            output[index++] = dis(random);
         }
-        output[index++] = masking_key[0];
-        output[index++] = masking_key[1];
-        output[index++] = masking_key[2];
-        output[index++] = masking_key[3];
+    }
+
+    return index;
+}
+
+// make_frame() creates a WebSocket frame, consisting of the header made by
+// make_frame_header() followed by the, possibly masked, payload.
+// The payload is located in the buffer \param payload, and has size \param payload_size.
+// \param output is the output buffer. It must be large enough to contain the frame.
+// The frame size can at most be payload_size + 14.
+// The return value is the size of the frame.
+size_t make_frame(bool fin, int opcode, bool mask, const char* payload, size_t payload_size, char* output,
+                  std::mt19937_64& random)
+{
+    size_t index = make_frame_header(fin, opcode, mask, payload_size, output, random);
+    if (mask) {
+        char* masking_key = output + index - 4;
         mask_payload(masking_key, payload, payload_size, output + index);
     }
     else {
@@ -338,8 +352,10 @@ private:
     char control_buffer[125]; // close, ping, pong.
 
     // A text or binary message can be fragmented. The
-    // message is built up in m_message_buffer.
-    std::vector<char> m_message_buffer;
+    // message is built up in m_message_buffer, and the
+    // payload of each frame is read directly into it.
+    // The buffer is not initialized when it is expanded.
+    util::Buffer<char> m_message_buffer;
 
     // The opcode of the message.
     websocket::Opcode m_message_opcode = websocket::Opcode::continuation;
@@ -350,8 +366,8 @@ private:
 
     // The message buffer has a minimum size,
     // and is extended when a large message arrives.
-    // The message_buffer is resized to this value after
-    // a larger message has been delivered.
+    // The expanded buffer is retained for subsequent
+    // messages.
     static const size_t s_message_buffer_min_size = 2048;
 
     enum class Stage { init, header_beginning, header_end, payload, delivery };
@@ -372,8 +388,7 @@ private:
         }
         else {
             size_t required_size = m_message_size + m_payload_size;
-            if (m_message_buffer.size() < required_size)
-                m_message_buffer.resize(required_size);
+            m_message_buffer.reserve(m_message_size, required_size); // Throws
 
             read_buffer = m_message_buffer.data() + m_message_size;
         }
@@ -381,8 +396,7 @@ private:
 
     void reset_message_buffer()
     {
-        if (m_message_buffer.size() != s_message_buffer_min_size)
-            m_message_buffer.resize(s_message_buffer_min_size);
+        m_message_buffer.reserve(0, s_message_buffer_min_size); // Throws
         m_message_opcode = websocket::Opcode::continuation;
         m_message_size = 0;
     }
@@ -668,6 +682,32 @@ public:
 
         bool mask = m_is_client;
 
+        // A large unmasked payload is written directly from the caller's
+        // buffer after the frame header, rather than being copied into the
+        // write buffer first. A masked payload must be copied, since masking
+        // cannot be done in place in the caller's buffer.
+        if (!mask && size >= s_direct_write_min_size) {
+            if (m_write_buffer.size() < s_write_buffer_stable_size)
+                m_write_buffer.resize(s_write_buffer_stable_size);
+            size_t header_size =
+                make_frame_header(fin, opcode, mask, size, m_write_buffer.data(), m_config.websocket_get_random());
+
+            auto handler = [=](std::error_code ec, size_t) {
+                // If the operation is aborted, the socket object may have been destroyed.
+                if (ec != util::error::operation_aborted) {
+                    if (ec) {
+                        stop();
+                        m_config.websocket_write_error_handler(ec);
+                        return;
+                    }
+                    async_write_buffer(data, size); // Throws
+                }
+            };
+
+            m_config.async_write(m_write_buffer.data(), header_size, handler);
+            return;
+        }
+
         // 14 is the maximum header length of a Websocket frame.
         size_t required_size = size + 14;
         if (m_write_buffer.size() < required_size)
@@ -676,6 +716,11 @@ public:
         size_t message_size =
             make_frame(fin, opcode, mask, data, size, m_write_buffer.data(), m_config.websocket_get_random());
 
+        async_write_buffer(m_write_buffer.data(), message_size); // Throws
+    }
+
+    void async_write_buffer(const char* data, size_t size)
+    {
         auto handler = [=](std::error_code ec, size_t) {
             // If the operation is aborted, the socket object may have been destroyed.
             if (ec != util::error::operation_aborted) {
@@ -688,7 +733,7 @@ public:
             }
         };
 
-        m_config.async_write(m_write_buffer.data(), message_size, handler);
+        m_config.async_write(data, size, handler);
     }
 
     void handle_write_message()
@@ -727,6 +772,10 @@ private:
     std::vector<char> m_write_buffer;
     static const size_t s_write_buffer_stable_size = 2048;
 
+    // Unmasked payloads of at least this size are written directly from the
+    // caller's buffer, at the cost of a separate write for the frame header.
+    static const size_t s_direct_write_min_size = 16384;
+
     std::function<void()> m_write_completion_handler;
 
     void error_client_malformed_response()
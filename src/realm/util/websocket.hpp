@@ -135,7 +135,9 @@ public:
     /// async_write_frame() sends a single frame with this content:
     /// \param fin The fin bit set to 0 or 1
     /// \param opcode Specifies the opcpde.
-    /// \param data size The frame payload is taken from this buffer.
+    /// \param data size The frame payload is taken from this buffer. The buffer
+    /// must remain valid until the handler is called, as a large payload may be
+    /// written directly from it.
     /// \param handler Called when the frame has been successfully sent. Error s are reported through
     /// websocket_write_error_handler() in Config.
     /// This function is rather low level and should only be used with knowledge of the WebSocket protocol.
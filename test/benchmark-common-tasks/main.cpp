@@ -20,6 +20,7 @@
 #include <set>
 #include <sstream>
 #include <set>
+#include <thread>
 
 #include <realm.hpp>
 #include <realm/query_expression.hpp> // only needed to compile on v2.6.0
@@ -807,6 +808,44 @@ struct BenchmarkIntVsDoubleColumns : Benchmark {
 };
 
 
+struct BenchmarkQueryArithmetic : Benchmark {
+    ColKey price_col;
+    ColKey quantity_col;
+    constexpr static size_t num_rows = BASE_SIZE * 4;
+    void before_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        TableRef t = tr.add_table(name());
+        price_col = t->add_column(type_Double, "price");
+        quantity_col = t->add_column(type_Int, "quantity");
+        Random r;
+        for (size_t i = 0; i < num_rows; ++i) {
+            t->create_object()
+                .set(price_col, r.draw_int<int64_t>(1, 10000) / 100.0)
+                .set<Int>(quantity_col, r.draw_int<int64_t>(1, 100));
+        }
+        tr.commit();
+    }
+    const char* name() const
+    {
+        return "QueryArithmetic";
+    }
+    void operator()(DBRef)
+    {
+        TableRef table = m_table;
+        Query q = table->column<Double>(price_col) * table->column<Int>(quantity_col) > 1000;
+        size_t count = q.count();
+        REALM_ASSERT(count > 0 && count < num_rows);
+    }
+
+    void after_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        tr.get_group().remove_table(name());
+        tr.commit();
+    }
+};
+
 struct BenchmarkQueryIntListSize : Benchmark {
     ColKey int_list_col_ndx;
     constexpr static size_t num_rows = BASE_SIZE * 4;
@@ -1207,6 +1246,114 @@ struct BenchmarkEmptyCommit : Benchmark {
     }
 };
 
+// Commits a transaction which modifies a quarter of the objects in a large
+// table, so that a lot of arrays spread over the file must be written.
+struct BenchmarkCommitLargeTransaction : Benchmark {
+    const char* name() const
+    {
+        return "CommitLargeTransaction";
+    }
+
+    static const size_t row_count = 250'000;
+
+    void before_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        TableRef t = tr.add_table(name());
+        m_col = t->add_column(type_Int, "i");
+        m_col_str = t->add_column(type_String, "s");
+#ifdef REALM_CLUSTER_IF
+        t->create_objects(row_count, m_keys);
+        for (size_t i = 0; i < row_count; ++i) {
+            Obj obj = t->get_object(m_keys[i]);
+            obj.set(m_col, int64_t(i));
+            obj.set(m_col_str, StringData(util::to_string(i)));
+        }
+#else
+        t->add_empty_row(row_count);
+        for (size_t i = 0; i < row_count; ++i) {
+            t->set_int(m_col, i, int64_t(i));
+            t->set_string(m_col_str, i, util::to_string(i));
+        }
+#endif
+        tr.commit();
+    }
+
+    void before_each(DBRef group)
+    {
+        Benchmark::before_each(group);
+        ++m_round;
+        for (size_t i = m_round % 4; i < row_count; i += 4) {
+#ifdef REALM_CLUSTER_IF
+            Obj obj = m_table->get_object(m_keys[i]);
+            obj.set(m_col, int64_t(i + m_round));
+            obj.set(m_col_str, StringData(util::to_string(i + m_round)));
+#else
+            m_table->set_int(m_col, i, int64_t(i + m_round));
+            m_table->set_string(m_col_str, i, util::to_string(i + m_round));
+#endif
+        }
+    }
+
+    void operator()(DBRef)
+    {
+        m_tr->commit();
+    }
+
+    ColKey m_col_str;
+    size_t m_round = 0;
+};
+
+struct BenchmarkStartRead : Benchmark {
+    const char* name() const
+    {
+        return "StartRead";
+    }
+    void before_all(DBRef) {}
+    void after_all(DBRef) {}
+    void before_each(DBRef db)
+    {
+        // keep the latest version bound, as a notifier or UI thread would
+        m_pinned.reset(new RdTrans(db));
+    }
+    void after_each(DBRef)
+    {
+        m_pinned.reset();
+    }
+    void operator()(DBRef db)
+    {
+        // use groups of 1000 to get measurable times
+        for (size_t i = 0; i < 1000; ++i) {
+            RdTrans tr(db);
+        }
+    }
+    std::unique_ptr<RdTrans> m_pinned;
+};
+
+#ifdef REALM_CLUSTER_IF
+// Read transactions started from several threads sharing one DB
+struct BenchmarkStartReadConcurrent : BenchmarkStartRead {
+    const char* name() const
+    {
+        return "StartReadConcurrent";
+    }
+    void operator()(DBRef db)
+    {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < num_threads; ++t) {
+            threads.emplace_back([db] {
+                for (size_t i = 0; i < 1000; ++i) {
+                    RdTrans tr(db);
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+    }
+    static constexpr size_t num_threads = 4;
+};
+#endif
+
 struct BenchmarkSortInt : BenchmarkWithInts {
     const char* name() const
     {
@@ -1220,6 +1367,34 @@ struct BenchmarkSortInt : BenchmarkWithInts {
     }
 };
 
+struct BenchmarkDistinctStringFewDupes : BenchmarkWithStringsFewDup {
+    const char* name() const
+    {
+        return "DistinctStringFewDupes";
+    }
+
+    void operator()(DBRef)
+    {
+        ConstTableRef table = m_table;
+        ConstTableView view = table->where().find_all();
+        view.distinct(m_col);
+    }
+};
+
+struct BenchmarkDistinctInt : BenchmarkWithInts {
+    const char* name() const
+    {
+        return "DistinctInt";
+    }
+
+    void operator()(DBRef)
+    {
+        ConstTableRef table = m_table;
+        ConstTableView view = table->where().find_all();
+        view.distinct(m_col);
+    }
+};
+
 struct BenchmarkInsert : BenchmarkWithStringsTable {
     const char* name() const
     {
@@ -1544,6 +1719,86 @@ struct BenchmarkQueryNot : Benchmark {
 
 };
 
+// A selective condition ANDed with a negated or wide condition. The matches
+// are produced incrementally, as for lazily evaluated results, so the other
+// condition is probed from each match of the selective one to the end of its
+// cluster, but only needs to be tested for the rows matching the selective one.
+struct BenchmarkQuerySelectiveAndNot : Benchmark {
+    const char* name() const
+    {
+        return "QuerySelectiveAndNot";
+    }
+
+    void before_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        TableRef table = tr.add_table(name());
+        m_col = table->add_column(type_Int, "selective");
+        m_col_str = table->add_column(type_String, "str");
+        for (size_t i = 0; i < BASE_SIZE; ++i) {
+            table->create_object().set(m_col, int64_t(i % 1000)).set(m_col_str, util::to_string(i % 100));
+        }
+        tr.commit();
+    }
+
+    virtual Query make_query(ConstTableRef table)
+    {
+        return table->where().equal(m_col, 0).Not().equal(m_col_str, "1");
+    }
+
+    void operator()(DBRef)
+    {
+        QueryCursor cursor(make_query(m_table));
+        std::vector<ObjKey> keys;
+        while (cursor.next(100, keys) == 100)
+            ;
+        REALM_ASSERT_EX(keys.size() == BASE_SIZE / 1000, keys.size());
+    }
+
+    void after_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        tr.get_group().remove_table(name());
+        tr.commit();
+    }
+
+    ColKey m_col_str;
+};
+
+struct BenchmarkQuerySelectiveAndWideOr : BenchmarkQuerySelectiveAndNot {
+    const char* name() const
+    {
+        return "QuerySelectiveAndWideOr";
+    }
+
+    Query make_query(ConstTableRef table)
+    {
+        return table->where()
+            .equal(m_col, 0)
+            .group()
+            .equal(m_col_str, "0")
+            .Or()
+            .equal(m_col_str, "10")
+            .Or()
+            .equal(m_col_str, "20")
+            .Or()
+            .equal(m_col_str, "30")
+            .Or()
+            .equal(m_col_str, "40")
+            .Or()
+            .equal(m_col_str, "50")
+            .Or()
+            .equal(m_col_str, "60")
+            .Or()
+            .equal(m_col_str, "70")
+            .Or()
+            .equal(m_col_str, "80")
+            .Or()
+            .equal(m_col_str, "90")
+            .end_group();
+    }
+};
+
 struct BenchmarkGetLinkList : Benchmark {
     const char* name() const
     {
@@ -1608,6 +1863,71 @@ struct BenchmarkGetLinkList : Benchmark {
     ColKey m_col_link;
 };
 
+// Many objects linking to the same "hub" object. Removing the links one at a
+// time must find each of them in the large backlink list of the hub.
+struct BenchmarkRemoveBacklinksFromHub : Benchmark {
+    const char* name() const
+    {
+        return "RemoveBacklinksFromHub";
+    }
+    static const size_t rows = BASE_SIZE / 10;
+
+    void before_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        std::string n = std::string(name()) + "_Hub";
+        TableRef hubs = tr.add_table(n);
+        TableRef table = tr.add_table(name());
+        m_col_link = table->add_column(*hubs, "hub");
+        ObjKey hub = hubs->create_object().get_key();
+        m_other_hub = hubs->create_object().get_key();
+        table->create_objects(rows, m_keys);
+        for (auto key : m_keys)
+            table->get_object(key).set(m_col_link, hub);
+        tr.commit();
+
+        // remove the links in random order
+        std::random_device rd;
+        std::mt19937 g(rd());
+        std::shuffle(m_keys.begin(), m_keys.end(), g);
+    }
+
+    void operator()(DBRef)
+    {
+        TableRef table = m_table;
+        for (auto key : m_keys)
+            table->remove_object(key);
+        // note: abort transaction so next run can start afresh
+    }
+
+    void after_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        tr.get_group().remove_table(name());
+        tr.get_group().remove_table(std::string(name()) + "_Hub");
+        tr.commit();
+        Benchmark::after_all(group);
+    }
+
+    ColKey m_col_link;
+    ObjKey m_other_hub;
+};
+
+struct BenchmarkRelinkFromHub : BenchmarkRemoveBacklinksFromHub {
+    const char* name() const
+    {
+        return "RelinkFromHub";
+    }
+
+    void operator()(DBRef)
+    {
+        TableRef table = m_table;
+        for (auto key : m_keys)
+            table->get_object(key).set(m_col_link, m_other_hub);
+        // note: abort transaction so next run can start afresh
+    }
+};
+
 struct BenchmarkNonInitiatorOpen : Benchmark {
     const char* name() const
     {
@@ -1666,6 +1986,114 @@ struct BenchmarkInitiatorOpen : public BenchmarkNonInitiatorOpen {
     }
 };
 
+// Opens the file the way short-lived readers do: Without a lock file, history
+// or free space management.
+struct BenchmarkReadOnlyOpen : public BenchmarkNonInitiatorOpen {
+    const char* name() const
+    {
+        return "ReadOnlyOpen";
+    }
+    void before_all(DBRef r)
+    {
+        BenchmarkNonInitiatorOpen::before_all(r); // create file
+        {
+            WrtTrans tr(initiator);
+            TableRef t = tr.add_table(name());
+            t->add_column(type_Int, "i");
+            tr.commit();
+        }
+        initiator.reset(); // for close.
+    }
+    void operator()(DBRef)
+    {
+        // use groups of 10 to get higher times
+        for (size_t i = 0; i < 10; ++i) {
+            Group g(*path, m_encryption_key, Group::mode_ReadOnly);
+            static_cast<void>(g.get_table(name()));
+        }
+    }
+};
+
+// Reads every page of a file that has just been opened. With encryption, each
+// page is decrypted as it is first accessed.
+struct BenchmarkReadWholeFile : public BenchmarkNonInitiatorOpen {
+    const char* name() const
+    {
+        return "ReadWholeFile";
+    }
+    static const size_t rows = BASE_SIZE / 4;
+
+    void before_all(DBRef r)
+    {
+        BenchmarkNonInitiatorOpen::before_all(r); // create file
+        {
+            WrtTrans tr(initiator);
+            TableRef t = tr.add_table(name());
+            m_col = t->add_column(type_Binary, "b");
+            std::string data(200, 'x');
+            for (size_t i = 0; i < rows; ++i)
+                t->create_object().set(m_col, BinaryData(data));
+            tr.commit();
+        }
+        initiator.reset(); // for close.
+    }
+    void operator()(DBRef)
+    {
+        Group g(*path, m_encryption_key, Group::mode_ReadOnly);
+        ConstTableRef t = g.get_table(name());
+        size_t total = 0;
+        for (auto& obj : *t)
+            total += obj.get<Binary>(m_col).size();
+        REALM_ASSERT_EX(total == rows * 200, total);
+    }
+};
+
+// Commits a change to every object, which dirties most of the pages of the
+// file. With encryption, the dirty pages are encrypted and written in runs.
+struct BenchmarkRewriteWholeFile : Benchmark {
+    const char* name() const
+    {
+        return "RewriteWholeFile";
+    }
+    static const size_t rows = BASE_SIZE / 4;
+
+    void before_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        TableRef t = tr.add_table(name());
+        m_col = t->add_column(type_Binary, "b");
+        std::string data(200, 'x');
+        t->create_objects(rows, m_keys);
+        for (auto key : m_keys)
+            t->get_object(key).set(m_col, BinaryData(data));
+        tr.commit();
+    }
+
+    void before_each(DBRef group)
+    {
+        Benchmark::before_each(group);
+        ++m_round;
+        std::string data(200, char('a' + m_round % 26));
+        for (auto key : m_keys)
+            m_table->get_object(key).set(m_col, BinaryData(data));
+    }
+
+    void operator()(DBRef)
+    {
+        m_tr->commit();
+    }
+
+    void after_all(DBRef group)
+    {
+        WrtTrans tr(group);
+        tr.get_group().remove_table(name());
+        tr.commit();
+        Benchmark::after_all(group);
+    }
+
+    size_t m_round = 0;
+};
+
 struct IterateTableByIterator : Benchmark {
     const char* name() const override
     {
@@ -1994,8 +2422,16 @@ int benchmark_common_tasks_main()
 
     BENCH2(BenchmarkEmptyCommit, true);
     BENCH2(BenchmarkEmptyCommit, false);
+    BENCH2(BenchmarkCommitLargeTransaction, true);
+    BENCH(BenchmarkStartRead);
+#ifdef REALM_CLUSTER_IF
+    BENCH(BenchmarkStartReadConcurrent);
+#endif
     BENCH2(BenchmarkNonInitiatorOpen, true);
     BENCH2(BenchmarkInitiatorOpen, true);
+    BENCH2(BenchmarkReadOnlyOpen, true);
+    BENCH2(BenchmarkReadWholeFile, true);
+    BENCH2(BenchmarkRewriteWholeFile, true);
     BENCH2(AddTable, true);
     BENCH2(AddTable, false);
 
@@ -2007,6 +2443,8 @@ int benchmark_common_tasks_main()
 
     BENCH(BenchmarkSort);
     BENCH(BenchmarkSortInt);
+    BENCH(BenchmarkDistinctStringFewDupes);
+    BENCH(BenchmarkDistinctInt);
 
     BENCH(BenchmarkUnorderedTableViewClear);
     BENCH(BenchmarkUnorderedTableViewClearIndexed);
@@ -2015,6 +2453,8 @@ int benchmark_common_tasks_main()
     BENCH(BenchmarkGetString);
     BENCH(BenchmarkSetString);
     BENCH(BenchmarkGetLinkList);
+    BENCH(BenchmarkRemoveBacklinksFromHub);
+    BENCH(BenchmarkRelinkFromHub);
     BENCH(BenchmarkInsert);
     BENCH2(BenchmarkCreateIndex, true);
     BENCH2(BenchmarkCreateIndex, false);
@@ -2029,6 +2469,8 @@ int benchmark_common_tasks_main()
     BENCH(BenchmarkFindFirstStringManyDupes);
     BENCH(BenchmarkQuery);
     BENCH(BenchmarkQueryNot);
+    BENCH(BenchmarkQuerySelectiveAndNot);
+    BENCH(BenchmarkQuerySelectiveAndWideOr);
     BENCH(BenchmarkQueryLongString);
 
     BENCH(BenchmarkQueryInsensitiveString);
@@ -2042,6 +2484,7 @@ int benchmark_common_tasks_main()
     BENCH(BenchmarkQueryIntEquality);
     BENCH(BenchmarkQueryIntEqualityIndexed);
     BENCH(BenchmarkIntVsDoubleColumns);
+    BENCH(BenchmarkQueryArithmetic);
     BENCH(BenchmarkQueryStringOverLinks);
     BENCH(BenchmarkQueryTimestampGreaterOverLinks);
     BENCH(BenchmarkQueryTimestampGreater);
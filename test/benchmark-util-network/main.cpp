@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include <realm/util/network.hpp>
+#include <realm/util/websocket.hpp>
 
 #include "../util/timer.hpp"
 #include "../util/random.hpp"
@@ -120,9 +121,9 @@ private:
     void initiate_read()
     {
         auto handler = [=](std::error_code ec, size_t) {
-            if (ec && ec != network::end_of_input)
+            if (ec && ec != util::MiscExtErrors::end_of_input)
                 throw std::system_error(ec);
-            if (ec != network::end_of_input)
+            if (ec != util::MiscExtErrors::end_of_input)
                 initiate_read();
         };
         m_read_socket.async_read(m_read_buffer, m_read_size, m_read_ahead_buffer, handler);
@@ -177,9 +178,9 @@ private:
     void initiate_read()
     {
         auto handler = [=](std::error_code ec, size_t) {
-            if (ec && ec != network::end_of_input)
+            if (ec && ec != util::MiscExtErrors::end_of_input)
                 throw std::system_error(ec);
-            if (ec != network::end_of_input)
+            if (ec != util::MiscExtErrors::end_of_input)
                 initiate_read();
         };
         m_read_socket.async_read(m_read_buffer, sizeof m_read_buffer, m_read_ahead_buffer, handler);
@@ -201,13 +202,133 @@ private:
     }
 };
 
+
+// Sends binary WebSocket messages from a server endpoint to a client
+// endpoint. Messages sent by the server are not masked, so this measures the
+// cost of framing, reassembly, and delivery of large messages, as is the case
+// for DOWNLOAD messages.
+class WebSocketTransfer {
+public:
+    WebSocketTransfer(size_t size, size_t num)
+        : m_message(size, 0)
+        , m_num_messages(num)
+    {
+        connect_sockets(m_client.socket, m_server.socket);
+    }
+
+    void run()
+    {
+        m_server.websocket.initiate_server_handshake();
+        m_client.websocket.initiate_client_handshake("/", "localhost", "benchmark");
+        m_service.run();
+        REALM_ASSERT(m_num_received == m_num_messages);
+    }
+
+private:
+    class Endpoint : public websocket::Config {
+    public:
+        WebSocketTransfer& transfer;
+        network::Socket socket;
+        websocket::Socket websocket{*this};
+
+        Endpoint(WebSocketTransfer& t)
+            : transfer(t)
+            , socket(t.m_service)
+        {
+        }
+
+        util::Logger& websocket_get_logger() noexcept override
+        {
+            return transfer.m_logger;
+        }
+
+        std::mt19937_64& websocket_get_random() noexcept override
+        {
+            return m_random;
+        }
+
+        void async_write(const char* data, size_t size, websocket::WriteCompletionHandler handler) override
+        {
+            socket.async_write(data, size, std::move(handler));
+        }
+
+        void async_read(char* buffer, size_t size, websocket::ReadCompletionHandler handler) override
+        {
+            socket.async_read(buffer, size, m_read_ahead_buffer, std::move(handler));
+        }
+
+        void async_read_until(char* buffer, size_t size, char delim,
+                              websocket::ReadCompletionHandler handler) override
+        {
+            socket.async_read_until(buffer, size, delim, m_read_ahead_buffer, std::move(handler));
+        }
+
+        void websocket_handshake_completion_handler(const HTTPHeaders&) override
+        {
+            if (this == &transfer.m_server)
+                transfer.initiate_write();
+        }
+
+        void websocket_read_error_handler(std::error_code ec) override
+        {
+            throw std::system_error(ec);
+        }
+
+        void websocket_write_error_handler(std::error_code ec) override
+        {
+            throw std::system_error(ec);
+        }
+
+        void websocket_handshake_error_handler(std::error_code ec, const HTTPHeaders*,
+                                               const util::StringView*) override
+        {
+            throw std::system_error(ec);
+        }
+
+        void websocket_protocol_error_handler(std::error_code ec) override
+        {
+            throw std::system_error(ec);
+        }
+
+        bool websocket_binary_message_received(const char*, size_t) override
+        {
+            if (++transfer.m_num_received == transfer.m_num_messages)
+                transfer.m_service.stop();
+            return true;
+        }
+
+    private:
+        std::mt19937_64 m_random;
+        network::ReadAheadBuffer m_read_ahead_buffer;
+    };
+
+    network::Service m_service;
+    util::StderrLogger m_logger;
+    Endpoint m_client{*this}, m_server{*this};
+    std::vector<char> m_message;
+    const size_t m_num_messages;
+    size_t m_num_sent = 0;
+    size_t m_num_received = 0;
+
+    void initiate_write()
+    {
+        if (m_num_sent == m_num_messages)
+            return;
+        ++m_num_sent;
+        auto handler = [=] {
+            initiate_write();
+        };
+        m_server.websocket.async_write_binary(m_message.data(), m_message.size(), handler);
+    }
+};
+
 } // unnamed namespace
 
 
 int main()
 {
     int max_lead_text_size = 12;
-    BenchmarkResults results(max_lead_text_size);
+    BenchmarkResults results(max_lead_text_size, "benchmark-util-network");
 
     Timer timer(Timer::type_UserTime);
     {
@@ -217,7 +338,7 @@ int main()
             task.run();
             results.submit("post", timer);
         }
-        results.finish("post", "Post");
+        results.finish("post", "Post", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Read task(1, 11500000); // (size, num)
@@ -225,7 +346,7 @@ int main()
             task.run();
             results.submit("read_1", timer);
         }
-        results.finish("read_1", "Read 1");
+        results.finish("read_1", "Read 1", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Read task(10, 9000000); // (size, num)
@@ -233,7 +354,7 @@ int main()
             task.run();
             results.submit("read_10", timer);
         }
-        results.finish("read_10", "Read 10");
+        results.finish("read_10", "Read 10", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Read task(100, 2700000); // (size, num)
@@ -241,7 +362,7 @@ int main()
             task.run();
             results.submit("read_100", timer);
         }
-        results.finish("read_100", "Read 100");
+        results.finish("read_100", "Read 100", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Read task(1000, 350000); // (size, num)
@@ -249,7 +370,7 @@ int main()
             task.run();
             results.submit("read_1000", timer);
         }
-        results.finish("read_1000", "Read 1000");
+        results.finish("read_1000", "Read 1000", "runtime_secs");
 
 
         for (int i = 0; i != 100; ++i) {
@@ -258,7 +379,7 @@ int main()
             task.run();
             results.submit("write_1", timer);
         }
-        results.finish("write_1", "Write 1");
+        results.finish("write_1", "Write 1", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Write task(10, 100000); // (size, num)
@@ -266,7 +387,7 @@ int main()
             task.run();
             results.submit("write_10", timer);
         }
-        results.finish("write_10", "Write 10");
+        results.finish("write_10", "Write 10", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Write task(100, 100000); // (size, num)
@@ -274,7 +395,7 @@ int main()
             task.run();
             results.submit("write_100", timer);
         }
-        results.finish("write_100", "Write 100");
+        results.finish("write_100", "Write 100", "runtime_secs");
 
         for (int i = 0; i != 100; ++i) {
             Write task(1000, 100000); // (size, num)
@@ -282,6 +403,23 @@ int main()
             task.run();
             results.submit("write_1000", timer);
         }
-        results.finish("write_1000", "Write 1000");
+        results.finish("write_1000", "Write 1000", "runtime_secs");
+
+
+        for (int i = 0; i != 100; ++i) {
+            WebSocketTransfer task(1000, 20000); // (size, num)
+            timer.reset();
+            task.run();
+            results.submit("websocket_1000", timer);
+        }
+        results.finish("websocket_1000", "WebSocket 1K", "runtime_secs");
+
+        for (int i = 0; i != 100; ++i) {
+            WebSocketTransfer task(1000000, 100); // (size, num)
+            timer.reset();
+            task.run();
+            results.submit("websocket_1000000", timer);
+        }
+        results.finish("websocket_1000000", "WebSocket 1M", "runtime_secs");
     }
 }
@@ -3625,6 +3625,64 @@ TEST_CASE("results: limit", "[limit]") {
     }
 }
 
+TEST_CASE("results: lazy evaluation", "[query]") {
+    InMemoryTestFile config;
+    config.automatic_change_notifications = false;
+    config.schema = Schema{
+        {"object",
+         {
+             {"value", PropertyType::Int},
+         }},
+    };
+
+    auto realm = Realm::get_shared_realm(config);
+    auto table = realm->read_group().get_table("class_object");
+    auto col = table->get_column_key("value");
+
+    realm->begin_transaction();
+    for (int i = 0; i < 1000; ++i) {
+        table->create_object().set(col, i % 5);
+    }
+    realm->commit_transaction();
+
+    Results r(realm, table->where().equal(col, 2));
+    r.set_evaluation_policy(Results::EvaluationPolicy::Lazy);
+    TableView tv = table->where().equal(col, 2).find_all();
+    REQUIRE(tv.size() == 200);
+
+    SECTION("objects are found in table order without running the query to completion") {
+        REQUIRE(r.get(0).get_key() == tv.get_key(0));
+        REQUIRE(r.get_mode() == Results::Mode::Query);
+        for (size_t i = 0; i < tv.size(); ++i)
+            REQUIRE(r.get(i).get_key() == tv.get_key(i));
+        REQUIRE(r.get_any(150).get_link().get_obj_key() == tv.get_key(150));
+        REQUIRE_THROWS_WITH(r.get(200), "Requested index 200 greater than max 199");
+        REQUIRE(r.get_mode() == Results::Mode::Query);
+    }
+
+    SECTION("the query is restarted when the table changes") {
+        REQUIRE(r.get(0).get_key() == tv.get_key(0));
+        realm->begin_transaction();
+        table->remove_object(tv.get_key(0));
+        REQUIRE(r.get(0).get_key() == tv.get_key(1));
+        realm->cancel_transaction();
+        REQUIRE(r.get(0).get_key() == tv.get_key(0));
+    }
+
+    SECTION("sorted results are evaluated in full") {
+        auto sorted = r.sort({{"value", true}});
+        REQUIRE(sorted.get(0).get_key() == tv.get_key(0));
+        REQUIRE(sorted.get_mode() == Results::Mode::TableView);
+    }
+
+    SECTION("frozen results keep the evaluation policy") {
+        auto frozen_realm = Realm::get_frozen_realm(config, realm->read_transaction_version());
+        Results frozen = r.freeze(frozen_realm);
+        REQUIRE(frozen.get(199).get_key() == tv.get_key(199));
+        REQUIRE(frozen.get_mode() == Results::Mode::Query);
+    }
+}
+
 TEST_CASE("notifications: objects with PK recreated") {
     _impl::RealmCoordinator::assert_no_open_realms();
 
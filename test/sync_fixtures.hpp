@@ -421,6 +421,7 @@ public:
 
         long client_max_open_files = 64;
         long server_max_open_files = 64;
+        std::uint_fast64_t server_max_open_files_size = 0;
 
         bool enable_server_ssl = false;
 
@@ -429,6 +430,7 @@ public:
 
         bool disable_download_compaction = false;
         bool disable_upload_compaction = false;
+        size_t client_upload_coalescing_max_size = 0;
 
         bool disable_history_compaction = false;
         std::chrono::seconds history_ttl = std::chrono::seconds::max();
@@ -437,6 +439,9 @@ public:
 
         size_t max_download_size = 0x1000000; // 16 MB as in Server::Config
 
+        bool server_enable_download_bootstrap_cache = false;
+        version_type server_download_bootstrap_cache_max_lag = 1024; // As in Server::Config
+
         bool one_connection_per_session = false;
 
         bool disable_upload_activation_delay = false;
@@ -511,6 +516,7 @@ public:
                 public_key = PKey::load_public(config.server_public_key_path);
             Server::Config config_2;
             config_2.max_open_files = config.server_max_open_files;
+            config_2.max_open_files_size = config.server_max_open_files_size;
             config_2.logger = &*m_server_loggers[i];
             config_2.token_expiration_clock = &m_fake_token_expiration_clock;
             config_2.metrics = config.server_metrics;
@@ -521,6 +527,8 @@ public:
             config_2.connection_reaper_interval = config.server_connection_reaper_interval;
             config_2.max_download_size = config.max_download_size;
             config_2.disable_download_compaction = config.disable_download_compaction;
+            config_2.enable_download_bootstrap_cache = config.server_enable_download_bootstrap_cache;
+            config_2.download_bootstrap_cache_max_lag = config.server_download_bootstrap_cache_max_lag;
             config_2.disable_history_compaction = config.disable_history_compaction;
             config_2.history_compaction_clock = config.history_compaction_clock;
             config_2.history_ttl = config.history_ttl;
@@ -547,6 +555,7 @@ public:
             config_2.ping_keepalive_period = config.client_ping_period;
             config_2.pong_keepalive_timeout = config.client_pong_timeout;
             config_2.disable_upload_compaction = config.disable_upload_compaction;
+            config_2.upload_coalescing_max_size = config.client_upload_coalescing_max_size;
             config_2.tcp_no_delay = true;
             config_2.one_connection_per_session = config.one_connection_per_session;
             config_2.disable_upload_activation_delay = config.disable_upload_activation_delay;
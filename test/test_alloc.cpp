@@ -131,6 +131,45 @@ TEST(Alloc_1)
 }
 
 
+TEST(Alloc_ReallocInPlace)
+{
+    SlabAlloc alloc;
+    alloc.attach_empty();
+
+    MemRef mr1 = alloc.alloc(64);
+    std::fill(mr1.get_addr(), mr1.get_addr() + 64, 0x5a);
+    set_capacity(mr1.get_addr(), 64);
+
+    // The block is followed by free space, so it can grow in place
+    MemRef mr2 = alloc.realloc_(mr1.get_ref(), mr1.get_addr(), 64, 256);
+    set_capacity(mr2.get_addr(), 256);
+    CHECK_EQUAL(mr1.get_ref(), mr2.get_ref());
+    CHECK_EQUAL(static_cast<void*>(mr1.get_addr()), static_cast<void*>(mr2.get_addr()));
+    CHECK_EQUAL(alloc.get_num_allocations(), 1);
+    CHECK_EQUAL(alloc.get_commit_size(), 256);
+
+    // The space not needed is still available
+    MemRef mr3 = alloc.alloc(64);
+    set_capacity(mr3.get_addr(), 64);
+    CHECK_GREATER(mr3.get_ref(), mr2.get_ref());
+    CHECK_EQUAL(alloc.get_num_allocations(), 2);
+
+    // Now the block is followed by one in use, so it must move
+    MemRef mr4 = alloc.realloc_(mr2.get_ref(), mr2.get_addr(), 256, 512);
+    set_capacity(mr4.get_addr(), 512);
+    CHECK_NOT_EQUAL(mr2.get_ref(), mr4.get_ref());
+    CHECK_EQUAL(alloc.get_num_allocations(), 3);
+    for (size_t i = 8; i < 64; ++i)
+        CHECK_EQUAL(int(mr4.get_addr()[i]), 0x5a);
+
+    alloc.free_(mr3.get_ref(), mr3.get_addr());
+    alloc.free_(mr4.get_ref(), mr4.get_addr());
+    CHECK_EQUAL(alloc.get_commit_size(), 0);
+
+    // SlabAlloc destructor will verify that all is free'd
+}
+
+
 TEST(Alloc_AttachFile)
 {
     GROUP_TEST_PATH(path);
@@ -3,6 +3,7 @@
 
 #include <realm/sync/noinst/compact_changesets.hpp>
 #include <realm/sync/changeset_encoder.hpp>
+#include <realm/sync/changeset_parser.hpp>
 #include <realm/sync/object.hpp>
 
 using namespace realm;
@@ -253,6 +254,65 @@ TEST_IF(CompactChangesets_EraseRecreate, false)
 }
 
 
+TEST(CompactChangesets_Concatenate)
+{
+    using Instruction = realm::sync::Instruction;
+    Changeset changesets[2];
+
+    {
+        Changeset& changeset = changesets[0];
+        Instruction::AddTable add_table;
+        add_table.table = changeset.intern_string("Foo");
+        add_table.type = Instruction::AddTable::PrimaryKeySpec{changeset.intern_string("_id"),
+                                                              Instruction::Payload::Type::String, false};
+        changeset.push_back(add_table);
+
+        Instruction::CreateObject create_object;
+        create_object.table = add_table.table;
+        create_object.object = changeset.intern_string("abc");
+        changeset.push_back(create_object);
+    }
+    {
+        // Interned in a different order than in the first changeset
+        Changeset& changeset = changesets[1];
+        Instruction::Update set;
+        set.field = changeset.intern_string("bar");
+        set.table = changeset.intern_string("Foo");
+        set.object = changeset.intern_string("abc");
+        set.value = Instruction::Payload{changeset.append_string("hello")};
+        changeset.push_back(set);
+    }
+
+    Changeset concatenated;
+    concatenate_changesets(changesets, 2, concatenated);
+    CHECK_EQUAL(concatenated.size(), 3);
+    CHECK_EQUAL(concatenated.interned_strings().size(), 4);
+
+    // Round trip through the encoder to check that all strings were carried over
+    util::AppendBuffer<char> buffer;
+    encode_changeset(concatenated, buffer);
+    realm::_impl::SimpleNoCopyInputStream stream{buffer.data(), buffer.size()};
+    Changeset parsed;
+    parse_changeset(stream, parsed);
+    CHECK_EQUAL(parsed.size(), 3);
+
+    auto it = parsed.begin();
+    auto& add_table = (*it)->get_as<Instruction::AddTable>();
+    CHECK_EQUAL(parsed.get_string(add_table.table), "Foo");
+    auto& spec = mpark::get<Instruction::AddTable::PrimaryKeySpec>(add_table.type);
+    CHECK_EQUAL(parsed.get_string(spec.field), "_id");
+    ++it;
+    auto& create_object = (*it)->get_as<Instruction::CreateObject>();
+    CHECK_EQUAL(parsed.get_string(create_object.table), "Foo");
+    CHECK_EQUAL(parsed.get_string(mpark::get<InternString>(create_object.object)), "abc");
+    ++it;
+    auto& set = (*it)->get_as<Instruction::Update>();
+    CHECK_EQUAL(parsed.get_string(set.table), "Foo");
+    CHECK_EQUAL(parsed.get_string(set.field), "bar");
+    CHECK_EQUAL(parsed.get_string(mpark::get<InternString>(set.object)), "abc");
+    CHECK_EQUAL(parsed.get_string(set.value.data.str), "hello");
+}
+
 #if 0
 TEST(CompactChangesets_PrimaryKeysRescueObjects)
 {
@@ -24,6 +24,7 @@
 
 #include <realm/util/aes_cryptor.hpp>
 #include <realm/util/encrypted_file_mapping.hpp>
+#include <realm/util/file_mapper.hpp>
 
 #include "test.hpp"
 
@@ -184,5 +185,83 @@ TEST(EncryptedFile_LargePages)
     close(fd);
 }
 
+TEST(EncryptedFile_MultiBlockReads)
+{
+    TEST_PATH(path);
+
+    // Enough blocks to span several metadata blocks
+    const size_t block_size = 4096;
+    const size_t num_blocks = 200;
+    std::unique_ptr<char[]> data(new char[num_blocks * block_size]);
+    for (size_t i = 0; i < num_blocks * block_size; ++i)
+        data[i] = static_cast<char>(i * 7 + i / block_size);
+
+    AESCryptor cryptor(test_key);
+    cryptor.set_file_size((num_blocks + 100) * block_size);
+    std::unique_ptr<char[]> buffer(new char[(num_blocks + 100) * block_size]);
+
+    int fd = open(path.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    cryptor.write(fd, 0, data.get(), num_blocks * block_size);
+
+    CHECK_EQUAL(cryptor.read(fd, 0, buffer.get(), num_blocks * block_size), num_blocks * block_size);
+    CHECK(memcmp(buffer.get(), data.get(), num_blocks * block_size) == 0);
+
+    CHECK_EQUAL(cryptor.read(fd, 30 * block_size, buffer.get(), 150 * block_size), 150 * block_size);
+    CHECK(memcmp(buffer.get(), data.get() + 30 * block_size, 150 * block_size) == 0);
+
+    // Reading past the blocks written stops at the first unwritten block
+    CHECK_EQUAL(cryptor.read(fd, 100 * block_size, buffer.get(), 200 * block_size), 100 * block_size);
+    CHECK(memcmp(buffer.get(), data.get() + 100 * block_size, 100 * block_size) == 0);
+
+    // A separate cryptor reads the IVs from the file
+    {
+        AESCryptor cryptor_2(test_key);
+        cryptor_2.set_file_size(num_blocks * block_size);
+        CHECK_EQUAL(cryptor_2.read(fd, 0, buffer.get(), num_blocks * block_size), num_blocks * block_size);
+        CHECK(memcmp(buffer.get(), data.get(), num_blocks * block_size) == 0);
+    }
+    close(fd);
+}
+
+TEST(EncryptedFile_MemoryPressureCap)
+{
+    constexpr int64_t no_match = PageReclaimGovernor::no_match;
+    {
+        // No limit without pressure, or with pressure below the threshold
+        MemoryPressureCap cap;
+        CHECK_EQUAL(cap.get_pressure_cap(1000, no_match, no_match), no_match);
+        CHECK_EQUAL(cap.get_pressure_cap(1000, 0, 4000), no_match);
+        CHECK_EQUAL(cap.get_pressure_cap(1000, MemoryPressureCap::pressure_threshold - 1, 4000), no_match);
+    }
+    {
+        // The higher the pressure, the lower the limit, but never below half
+        // the load
+        MemoryPressureCap cap;
+        CHECK_EQUAL(cap.get_pressure_cap(1000, MemoryPressureCap::pressure_threshold, no_match), 900);
+        CHECK_EQUAL(cap.get_pressure_cap(1000, 20, no_match), 800);
+        CHECK_EQUAL(cap.get_pressure_cap(1000, 80, no_match), 500);
+        CHECK_EQUAL(cap.get_pressure_cap(500, 100, no_match), 250);
+        // The limit is not raised while the pressure lasts
+        CHECK_EQUAL(cap.get_pressure_cap(1000, 20, no_match), 250);
+    }
+    {
+        // Once the pressure is gone, the limit is raised by 1/8 per run, and
+        // released when it no longer constrains the load
+        MemoryPressureCap cap;
+        CHECK_EQUAL(cap.get_pressure_cap(1000, 50, no_match), 500);
+        CHECK_EQUAL(cap.get_pressure_cap(500, 0, no_match), 563);
+        CHECK_EQUAL(cap.get_pressure_cap(500, no_match, no_match), 634);
+        CHECK_EQUAL(cap.get_pressure_cap(500, 0, no_match), 714);
+        CHECK_EQUAL(cap.get_pressure_cap(400, 0, no_match), no_match);
+    }
+    {
+        // ... or when it reaches the target derived from the system
+        MemoryPressureCap cap;
+        CHECK_EQUAL(cap.get_pressure_cap(1000, 50, 2000), 500);
+        CHECK_EQUAL(cap.get_pressure_cap(1000, 0, 600), 563);
+        CHECK_EQUAL(cap.get_pressure_cap(1000, 0, 600), no_match);
+    }
+}
+
 #endif // REALM_ENABLE_ENCRYPTION
 #endif // TEST_ENCRYPTED_FILE_MAPPING
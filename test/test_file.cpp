@@ -178,6 +178,44 @@ TEST(File_MapMultiplePages)
     }
 }
 
+TEST(File_MapAdvise)
+{
+    const size_t count = 4096 / sizeof(size_t) * 16;
+
+    TEST_PATH(path);
+    {
+        File f(path, File::mode_Write);
+        f.set_encryption_key(crypt_key());
+        f.resize(count * sizeof(size_t));
+
+        File::Map<size_t> map(f, File::access_ReadWrite, count * sizeof(size_t));
+        map.advise(File::hint_Sequential);
+        realm::util::encryption_read_barrier(map, 0, count);
+        for (size_t i = 0; i < count; ++i)
+            map.get_addr()[i] = i;
+        realm::util::encryption_write_barrier(map, 0, count);
+    }
+    {
+        // The hints do not change the contents seen through the mapping,
+        // whatever the range they are given for
+        File f(path, File::mode_Read);
+        f.set_encryption_key(crypt_key());
+        f.advise(File::hint_Random);
+        File::Map<size_t> map(f, File::access_ReadOnly, count * sizeof(size_t), File::map_Populate);
+        map.advise(File::hint_Random);
+        map.advise(File::hint_WillNeed, 4096 + 17, 3 * 4096);
+        map.advise(File::hint_WillNeed, count * sizeof(size_t) + 1);
+        map.advise(File::hint_Normal, 100);
+        realm::util::encryption_read_barrier(map, 0, count);
+        for (size_t i = 0; i < count; ++i) {
+            CHECK_EQUAL(map.get_addr()[i], i);
+            if (map.get_addr()[i] != i)
+                return;
+        }
+    }
+}
+
+
 TEST(File_ReaderAndWriter)
 {
     const size_t count = 4096 / sizeof(size_t) * 256 * 2;
@@ -807,6 +807,24 @@ TEST(Group_Invalid2)
     CHECK_THROW(Group(BinaryData(str, strlen(str))), InvalidDatabase);
 }
 
+TEST(Group_Invalid3)
+{
+    GROUP_TEST_PATH(path);
+
+    // Try to open files with invalid data, both shorter and longer than
+    // the header and footer together
+    {
+        File file(path, File::mode_Write);
+        file.write("invalid data");
+    }
+    CHECK_THROW(Group(path, nullptr), InvalidDatabase);
+    {
+        File file(path, File::mode_Write);
+        file.write(std::string(page_size(), 'x'));
+    }
+    CHECK_THROW(Group(path, nullptr), InvalidDatabase);
+}
+
 TEST(Group_Overwrite)
 {
     GROUP_TEST_PATH(path);
@@ -898,6 +898,162 @@ TEST(Links_LinkList_Backlinks)
 }
 
 
+TEST(Links_ManyBacklinks)
+{
+    // The positions of the entries of large backlink lists are looked up in
+    // a table of positions. Check that adding and removing backlinks in random
+    // order keeps them consistent with the forward links.
+    Random random(random_int<unsigned long>());
+    Group group;
+
+    auto target = group.add_table("target");
+    auto origin = group.add_table("origin");
+    auto col_link = origin->add_column(*target, "link");
+    auto col_list = origin->add_column_list(*target, "list");
+    Obj hub = target->create_object();
+    Obj other = target->create_object();
+
+    // Create the origin objects in random key order
+    std::vector<ObjKey> origin_keys;
+    for (int i = 0; i < 500; i++)
+        origin_keys.push_back(ObjKey(i * 7));
+    random.shuffle(origin_keys.begin(), origin_keys.end());
+    for (int i = 0; i < 500; i++) {
+        Obj obj = origin->create_object(origin_keys[i]);
+        obj.set(col_link, hub.get_key());
+        auto list = obj.get_linklist(col_list);
+        list.add(hub.get_key());
+        if (i % 3 == 0)
+            list.add(hub.get_key());
+    }
+    CHECK_EQUAL(hub.get_backlink_count(*origin, col_link), 500);
+    CHECK_EQUAL(hub.get_backlink_count(*origin, col_list), 667);
+    group.verify();
+
+    // Backlinks are kept in the order they were added
+    for (int i = 0; i < 500; i++)
+        CHECK_EQUAL(hub.get_backlink(*origin, col_link, i), origin_keys[i]);
+
+    // Many removals from the same list
+    for (int i = 0; i < 100; i++)
+        origin->get_object(origin_keys[i]).get_linklist(col_list).remove(0);
+    CHECK_EQUAL(hub.get_backlink_count(*origin, col_list), 567);
+    group.verify();
+
+    for (int i = 0; i < 2000; i++) {
+        ObjKey key = origin_keys[random.draw_int_mod(origin_keys.size())];
+        Obj obj = origin->get_object(key);
+        switch (random.draw_int_mod(3)) {
+            case 0:
+                obj.set(col_link, obj.get<ObjKey>(col_link) == hub.get_key() ? other.get_key() : hub.get_key());
+                break;
+            case 1: {
+                auto list = obj.get_linklist(col_list);
+                if (list.size() > 0)
+                    list.remove(random.draw_int_mod(list.size()));
+                break;
+            }
+            case 2:
+                obj.get_linklist(col_list).add(hub.get_key());
+                break;
+        }
+    }
+    group.verify();
+
+    size_t link_count = 0;
+    size_t list_count = 0;
+    for (auto& obj : *origin) {
+        if (obj.get<ObjKey>(col_link) == hub.get_key())
+            ++link_count;
+        auto list = obj.get_linklist(col_list);
+        for (size_t i = 0; i < list.size(); i++) {
+            if (list.get(i) == hub.get_key())
+                ++list_count;
+        }
+    }
+    CHECK_EQUAL(hub.get_backlink_count(*origin, col_link), link_count);
+    CHECK_EQUAL(hub.get_backlink_count(*origin, col_list), list_count);
+
+    // Removing the origin objects must remove all backlinks
+    for (size_t i = 0; i < origin_keys.size(); i += 2)
+        origin->remove_object(origin_keys[i]);
+    group.verify();
+    origin->clear();
+    CHECK_EQUAL(hub.get_backlink_count(), 0);
+    CHECK_EQUAL(other.get_backlink_count(), 0);
+}
+
+
+TEST(Links_ManyBacklinksAcrossTransactions)
+{
+    // The positions of the entries of a large backlink list are kept by the
+    // table accessor across transactions. Check that they are not trusted
+    // once the list has been changed by a rollback or by another DB.
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history(path);
+    DBRef db = DB::create(*hist);
+    std::vector<ObjKey> origin_keys;
+    ColKey col_link;
+    ObjKey hub;
+    {
+        auto wt = db->start_write();
+        auto target = wt->add_table("target");
+        auto origin = wt->add_table("origin");
+        col_link = origin->add_column(*target, "link");
+        hub = target->create_object().get_key();
+        for (int i = 0; i < 1000; i++)
+            origin_keys.push_back(origin->create_object().set(col_link, hub).get_key());
+        wt->commit();
+    }
+
+    auto check_backlinks = [&](Transaction& tr) {
+        auto origin = tr.get_table("origin");
+        Obj hub_obj = tr.get_table("target")->get_object(hub);
+        std::vector<ObjKey> backlinks;
+        for (size_t i = 0; i < hub_obj.get_backlink_count(*origin, col_link); i++)
+            backlinks.push_back(hub_obj.get_backlink(*origin, col_link, i));
+        std::vector<ObjKey> linking;
+        for (auto& obj : *origin) {
+            if (obj.get<ObjKey>(col_link) == hub)
+                linking.push_back(obj.get_key());
+        }
+        std::sort(backlinks.begin(), backlinks.end());
+        CHECK(backlinks == linking);
+    };
+    auto unlink = [&](Transaction& tr, size_t begin, size_t end) {
+        auto origin = tr.get_table("origin");
+        for (size_t i = begin; i < end; i++)
+            origin->get_object(origin_keys[i]).set(col_link, null_key);
+    };
+
+    auto tr = db->start_read();
+    tr->promote_to_write();
+    unlink(*tr, 0, 100);
+    tr->rollback_and_continue_as_read();
+    check_backlinks(*tr);
+
+    tr->promote_to_write();
+    unlink(*tr, 900, 1000);
+    tr->commit_and_continue_as_read();
+    check_backlinks(*tr);
+
+    {
+        auto hist_2 = make_in_realm_history(path);
+        DBRef db_2 = DB::create(*hist_2);
+        auto wt = db_2->start_write();
+        unlink(*wt, 500, 600);
+        wt->get_table("origin")->get_object(origin_keys[950]).set(col_link, hub);
+        wt->commit();
+    }
+
+    tr->promote_to_write();
+    unlink(*tr, 0, 200);
+    check_backlinks(*tr);
+    tr->commit_and_continue_as_read();
+    CHECK_EQUAL(tr->get_table("target")->get_object(hub).get_backlink_count(), 601);
+}
+
+
 TEST(Links_LinkList_FindByOrigin)
 {
     Group group;
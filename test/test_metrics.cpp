@@ -1093,6 +1093,121 @@ NONCONCURRENT_TEST_IF(Metrics_NumDecryptedPagesWithEncryption, REALM_ENABLE_ENCR
     CHECK_EQUAL(transactions->at(1).get_num_decrypted_pages(), 1);
 }
 
+// this test relies on the global state of the number of decrypted pages and therefore must be run in isolation
+NONCONCURRENT_TEST_IF(Metrics_DecryptedMemoryLimit, REALM_ENABLE_ENCRYPTION)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    auto sg = DB::create(*hist, DBOptions(crypt_key(true)));
+    {
+        auto tr = sg->start_write();
+        auto table = tr->add_table("table");
+        auto col = table->add_column(type_String, "value");
+        std::string value(1000, 'x');
+        for (int i = 0; i < 2000; ++i)
+            table->create_object().set(col, StringData(value));
+        tr->commit();
+    }
+    {
+        // Decrypt all of the data
+        auto rt = sg->start_read();
+        auto table = rt->get_table("table");
+        auto col = table->get_column_key("value");
+        size_t total_size = 0;
+        for (auto& obj : *table)
+            total_size += obj.get<String>(col).size();
+        CHECK_EQUAL(total_size, 2000 * 1000);
+    }
+
+    size_t reclaimed_before = get_decrypted_memory_stats().reclaimed_size;
+    set_decrypted_memory_limit(page_size());
+    auto on_exit = make_scope_exit([]() noexcept { set_decrypted_memory_limit(0); });
+
+    // The reclaimer only releases the pages which have not been accessed since
+    // its previous run, and the work done per run is limited
+    for (int i = 0; i < 10 && get_decrypted_memory_stats().reclaimed_size == reclaimed_before; ++i)
+        reclaim_decrypted_pages();
+
+    auto stats = get_decrypted_memory_stats();
+    CHECK_GREATER(stats.reclaimed_size, reclaimed_before);
+    CHECK_EQUAL(stats.reclaimer_target, page_size());
+
+    // The data is decrypted again as it is accessed
+    auto rt = sg->start_read();
+    auto table = rt->get_table("table");
+    auto col = table->get_column_key("value");
+    CHECK_EQUAL(table->begin()->get<String>(col), std::string(1000, 'x'));
+}
+
+TEST(Metrics_WriteLockWait)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.enable_metrics = true;
+    DBRef sg = DB::create(path, false, options);
+
+    auto wt = sg->start_write();
+    Thread thread;
+    thread.start([&] {
+        auto tr = sg->start_write(DB::WritePriority::High);
+        tr->commit();
+    });
+    millisleep(100);
+    wt->commit();
+    thread.join();
+
+    std::shared_ptr<Metrics> metrics = sg->get_metrics();
+    CHECK(metrics);
+    std::unique_ptr<Metrics::TransactionInfoList> transactions = metrics->take_transactions();
+    CHECK(transactions);
+    nanosecond_storage_t max_wait = 0;
+    for (auto& t : *transactions) {
+        if (t.get_transaction_type() == TransactionInfo::write_transaction)
+            max_wait = std::max(max_wait, t.get_lock_wait_time_nanoseconds());
+        CHECK_EQUAL(t.get_write_queue_depth(), 0);
+    }
+    CHECK_GREATER_EQUAL(max_wait, 50 * 1000 * 1000);
+}
+
+TEST(Metrics_CommitSize)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.enable_metrics = true;
+    DBRef sg = DB::create(path, false, options);
+
+    {
+        auto wt = sg->start_write();
+        auto table = wt->add_table("table");
+        auto col = table->add_column(type_Int, "int");
+        for (int i = 0; i < 1000; ++i)
+            table->create_object().set(col, i);
+        wt->commit();
+    }
+    {
+        auto rt = sg->start_read();
+    }
+
+    std::shared_ptr<Metrics> metrics = sg->get_metrics();
+    CHECK(metrics);
+    std::unique_ptr<Metrics::TransactionInfoList> transactions = metrics->take_transactions();
+    CHECK(transactions);
+    size_t num_writes = 0;
+    for (auto& t : *transactions) {
+        if (t.get_transaction_type() == TransactionInfo::write_transaction) {
+            ++num_writes;
+            CHECK_GREATER_EQUAL(t.get_commit_size(), 1000 * sizeof(int16_t));
+            CHECK_GREATER(t.get_num_allocations(), 0);
+            CHECK_LESS(t.get_num_allocations(), 1000);
+        }
+        else {
+            CHECK_EQUAL(t.get_commit_size(), 0);
+            CHECK_EQUAL(t.get_num_allocations(), 0);
+        }
+    }
+    CHECK_EQUAL(num_writes, 1);
+}
+
 TEST(Metrics_MemoryChecks)
 {
     SHARED_GROUP_TEST_PATH(path);
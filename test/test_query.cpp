@@ -22,6 +22,8 @@
 #include <cstdlib> // itoa()
 #include <limits>
 #include <vector>
+#include <map>
+#include <set>
 #include <chrono>
 
 using namespace std::chrono;
@@ -3801,6 +3803,348 @@ TEST(Query_FindAllRangeOr)
     CHECK_EQUAL(3, tv3.size());
 }
 
+TEST(Query_WideOrAndNot)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+
+    Table table;
+    auto col_a = table.add_column(type_Int, "a");
+    auto col_b = table.add_column(type_Int, "b");
+    auto col_c = table.add_column(type_Int, "c");
+    auto col_d = table.add_column(type_Int, "d", true);
+    table.add_search_index(col_c);
+
+    for (size_t i = 0; i < 3000; ++i) {
+        auto obj = table.create_object().set_all(random.draw_int<int64_t>(0, 9), random.draw_int<int64_t>(0, 9),
+                                                 random.draw_int<int64_t>(0, 9));
+        if (random.draw_bool())
+            obj.set(col_d, random.draw_int<int64_t>(0, 9));
+    }
+
+    auto wide_or = [&](const Obj& obj) {
+        return obj.get<Int>(col_a) == 1 || obj.get<Int>(col_b) > 7 || obj.get<Int>(col_c) == 3 ||
+               obj.get<Int>(col_c) == 5 || (!obj.is_null(col_d) && obj.get<Int>(col_d) < 2);
+    };
+    auto make_wide_or = [&](Query q) {
+        return q.group()
+            .equal(col_a, 1)
+            .Or()
+            .greater(col_b, 7)
+            .Or()
+            .equal(col_c, 3)
+            .Or()
+            .equal(col_c, 5)
+            .Or()
+            .less(col_d, 2)
+            .end_group();
+    };
+
+    auto check = [&](Query q, auto&& expected) {
+        std::vector<ObjKey> keys;
+        size_t matches_in_range = 0;
+        int64_t sum = 0;
+        size_t ndx = 0;
+        for (auto& obj : table) {
+            if (expected(obj)) {
+                keys.push_back(obj.get_key());
+                sum += obj.get<Int>(col_a);
+                if (ndx >= 1000 && ndx < 2000)
+                    ++matches_in_range;
+            }
+            ++ndx;
+        }
+        TableView tv = q.find_all();
+        CHECK_EQUAL(tv.size(), keys.size());
+        for (size_t i = 0; i < keys.size() && i < tv.size(); ++i)
+            CHECK_EQUAL(tv.get_key(i), keys[i]);
+        CHECK_EQUAL(q.count(), keys.size());
+        CHECK_EQUAL(q.sum_int(col_a), sum);
+        CHECK_EQUAL(q.find(), keys.empty() ? ObjKey() : keys.front());
+
+        TableView limited = q.find_all(0, size_t(-1), 10);
+        CHECK_EQUAL(limited.size(), std::min(keys.size(), size_t(10)));
+        TableView range = q.find_all(1000, 2000);
+        CHECK_EQUAL(range.size(), matches_in_range);
+        for (size_t i = 0; i < 50; ++i) {
+            auto obj = table.get_object(random.draw_int_mod(table.size()));
+            CHECK_EQUAL(q.eval_object(obj), expected(obj));
+        }
+    };
+
+    check(make_wide_or(table.where()), wide_or);
+    check(make_wide_or(table.where().not_equal(col_b, 3)), [&](const Obj& obj) {
+        return obj.get<Int>(col_b) != 3 && wide_or(obj);
+    });
+    check(make_wide_or(table.where().Not()), [&](const Obj& obj) {
+        return !wide_or(obj);
+    });
+    check(table.where().Not().equal(col_c, 4), [&](const Obj& obj) {
+        return obj.get<Int>(col_c) != 4;
+    });
+    check(table.where().greater(col_a, 4).Not().group().equal(col_c, 4).Or().equal(col_b, 2).end_group(),
+          [&](const Obj& obj) {
+              return obj.get<Int>(col_a) > 4 && !(obj.get<Int>(col_c) == 4 || obj.get<Int>(col_b) == 2);
+          });
+    // A selective condition probes the negated and the wide conditions from each of its matches
+    check(table.where().equal(col_c, 7).equal(col_a, 2).Not().equal(col_b, 4), [&](const Obj& obj) {
+        return obj.get<Int>(col_c) == 7 && obj.get<Int>(col_a) == 2 && obj.get<Int>(col_b) != 4;
+    });
+    check(make_wide_or(table.where().equal(col_c, 7).equal(col_b, 8)), [&](const Obj& obj) {
+        return obj.get<Int>(col_c) == 7 && obj.get<Int>(col_b) == 8 && wide_or(obj);
+    });
+}
+
+
+TEST(Query_Cursor)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    DBRef db = DB::create(*hist, DBOptions(crypt_key()));
+
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        col = table->add_column(type_Int, "int");
+        for (int64_t i = 0; i < 3000; ++i)
+            table->create_object().set(col, i % 7);
+        wt->commit();
+    }
+
+    auto frozen = db->start_frozen();
+    auto table = frozen->get_table("table");
+    Query q = table->where().equal(col, 3);
+    TableView tv = q.find_all();
+
+    // Batches of different sizes stop at different positions within the clusters
+    for (size_t batch_size : {1, 10, 33, 1000}) {
+        QueryCursor cursor(q);
+        std::vector<ObjKey> keys;
+        CHECK_EQUAL(cursor.next(0, keys), 0);
+        while (cursor.next(batch_size, keys) == batch_size)
+            ;
+        CHECK(cursor.at_end());
+        CHECK_EQUAL(cursor.next(batch_size, keys), 0);
+        CHECK_EQUAL(keys.size(), tv.size());
+        for (size_t i = 0; i < keys.size() && i < tv.size(); ++i)
+            CHECK_EQUAL(keys[i], tv.get_key(i));
+
+        cursor.reset();
+        keys.clear();
+        CHECK_EQUAL(cursor.next(1, keys), 1);
+        CHECK_EQUAL(keys[0], tv.get_key(0));
+    }
+
+    // A query without conditions visits every object
+    QueryCursor all(table->where());
+    std::vector<ObjKey> all_keys;
+    CHECK_EQUAL(all.next(5000, all_keys), 3000);
+    CHECK(all.at_end());
+
+    // Continue after the table has changed
+    auto wt = db->start_write();
+    auto live_table = wt->get_table("table");
+    QueryCursor cursor(live_table->where().equal(col, 3));
+    std::vector<ObjKey> keys;
+    CHECK_EQUAL(cursor.next(100, keys), 100);
+    live_table->remove_object(keys.front());
+    live_table->get_object(tv.get_key(100)).set(col, 4);
+    ObjKey added = live_table->create_object().set(col, 3).get_key();
+    while (cursor.next(64, keys))
+        ;
+    std::vector<ObjKey> expected;
+    for (size_t i = 0; i < tv.size(); ++i) {
+        if (i != 100)
+            expected.push_back(tv.get_key(i));
+    }
+    expected.push_back(added);
+    CHECK(keys == expected);
+}
+
+TEST(Query_MaterializedAggregate)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    DBRef db = DB::create(*hist, DBOptions(crypt_key()));
+
+    ColKey col_int, col_double, col_str;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        col_int = table->add_column(type_Int, "int", true);
+        col_double = table->add_column(type_Double, "double");
+        col_str = table->add_column(type_String, "str");
+        for (int64_t i = 0; i < 3000; ++i) {
+            Obj obj = table->create_object().set(col_double, double(i % 100)).set(col_str, i % 3 ? "a" : "b");
+            if (i % 11)
+                obj.set(col_int, i % 1000);
+        }
+        wt->commit();
+    }
+
+    auto check = [&](ConstTableRef table, const MaterializedAggregate& ints, const MaterializedAggregate& doubles) {
+        size_t count = 0;
+        size_t value_count = 0;
+        int64_t sum = 0;
+        double double_sum = 0;
+        util::Optional<int64_t> min, max;
+        for (auto& obj : *table) {
+            if (obj.get<String>(col_str) != "a")
+                continue;
+            ++count;
+            double_sum += obj.get<double>(col_double);
+            if (auto value = obj.get<util::Optional<int64_t>>(col_int)) {
+                ++value_count;
+                sum += *value;
+                min = min ? std::min(*min, *value) : *value;
+                max = max ? std::max(*max, *value) : *value;
+            }
+        }
+        CHECK_EQUAL(ints.count(), count);
+        CHECK_EQUAL(ints.sum(), Mixed(sum));
+        CHECK_EQUAL(ints.min(), min ? Mixed(*min) : Mixed());
+        CHECK_EQUAL(ints.max(), max ? Mixed(*max) : Mixed());
+        CHECK_EQUAL(ints.average(), value_count ? Mixed(double(sum) / value_count) : Mixed());
+        CHECK_EQUAL(doubles.count(), count);
+        CHECK_EQUAL(doubles.sum(), Mixed(double_sum));
+    };
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("table");
+    MaterializedAggregate ints(table->where().equal(col_str, "a"), col_int);
+    MaterializedAggregate doubles(table->where().equal(col_str, "a"), col_double);
+    check(table, ints, doubles);
+    check(table, ints, doubles);
+
+    CHECK_EQUAL(MaterializedAggregate(table->where()).count(), 3000);
+    CHECK_THROW(MaterializedAggregate(table->where(), col_str), LogicError);
+    CHECK_THROW(MaterializedAggregate(table->where()).sum(), LogicError);
+
+    // Changes committed by another transaction only touch a few clusters
+    {
+        auto wt = db->start_write();
+        auto t = wt->get_table("table");
+        t->get_object(5).set(col_int, 5000);
+        t->get_object(6).set_null(col_int);
+        t->get_object(2000).set(col_str, "b");
+        t->remove_object(t->get_object(2500).get_key());
+        t->create_object().set(col_str, "a").set(col_int, -17);
+        wt->commit();
+    }
+    rt->advance_read();
+    check(table, ints, doubles);
+
+    // Uncommitted changes in a write transaction
+    rt->promote_to_write();
+    table->get_object(1).set(col_str, "b");
+    table->get_object(1500).set(col_int, -1000);
+    check(table, ints, doubles);
+    rt->rollback_and_continue_as_read();
+    check(table, ints, doubles);
+
+    auto frozen = rt->freeze();
+    auto frozen_table = frozen->get_table("table");
+    MaterializedAggregate frozen_ints(frozen_table->where().equal(col_str, "a"), col_int);
+    MaterializedAggregate frozen_doubles(frozen_table->where().equal(col_str, "a"), col_double);
+    check(frozen_table, frozen_ints, frozen_doubles);
+
+    // Removing every matching object
+    {
+        auto wt = db->start_write();
+        wt->get_table("table")->where().equal(col_str, "a").find_all().clear();
+        wt->commit();
+    }
+    rt->advance_read();
+    check(table, ints, doubles);
+    CHECK_EQUAL(ints.count(), 0);
+    CHECK(ints.min().is_null());
+    check(frozen_table, frozen_ints, frozen_doubles);
+}
+
+
+TEST(Query_MaterializedAggregateSelfLink)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    DBRef db = DB::create(*hist, DBOptions(crypt_key()));
+
+    ColKey col_value, col_parent;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        col_value = table->add_column(type_Int, "value");
+        col_parent = table->add_column_link(type_Link, "parent", *table);
+        for (int64_t i = 0; i < 1000; ++i)
+            table->create_object(ObjKey(i));
+        for (int64_t i = 0; i < 500; ++i)
+            table->get_object(ObjKey(i)).set(col_parent, ObjKey(900));
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("table");
+    Query q = table->link(col_parent).column<Int>(col_value) > 5;
+    MaterializedAggregate agg(q);
+    CHECK_EQUAL(agg.count(), 0);
+
+    // The matches in the clusters holding the linking objects change even
+    // though only the cluster holding the target object is modified
+    {
+        auto wt = db->start_write();
+        wt->get_table("table")->get_object(ObjKey(900)).set(col_value, 10);
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_EQUAL(q.count(), 500);
+    CHECK_EQUAL(agg.count(), 500);
+
+    // Through backlinks
+    Query q2 = table->backlink(*table, col_parent).column<Int>(col_value) > 5;
+    MaterializedAggregate agg2(q2);
+    CHECK_EQUAL(agg2.count(), 0);
+    {
+        auto wt = db->start_write();
+        wt->get_table("table")->get_object(ObjKey(3)).set(col_value, 10);
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_EQUAL(q2.count(), 1);
+    CHECK_EQUAL(agg2.count(), 1);
+}
+
+TEST(Query_MaterializedAggregateMovesPin)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    DBRef db = DB::create(*hist, DBOptions(crypt_key()));
+
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        col = wt->add_table("table")->add_column(type_Int, "value");
+        wt->add_table("other");
+        for (int64_t i = 0; i < 1000; ++i)
+            wt->get_table("table")->create_object().set(col, i);
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("table");
+    MaterializedAggregate agg(table->where().greater(col, 500), col);
+    CHECK_EQUAL(agg.count(), 499);
+
+    // Commits which do not change the table do not leave the version the
+    // aggregate was computed at pinned once it is read again
+    for (int i = 0; i < 3; ++i) {
+        auto wt = db->start_write();
+        wt->get_table("other")->create_object();
+        wt->commit();
+        rt->advance_read();
+        CHECK_EQUAL(agg.count(), 499);
+    }
+    CHECK_EQUAL(db->get_number_of_versions(), 2);
+}
+
 
 TEST(Query_SimpleStr)
 {
@@ -3937,6 +4281,73 @@ TEST(Query_SortAscending)
     }
 }
 
+TEST(Query_SortLargeViews)
+{
+    // Large views are radix sorted on the first column. The result must be
+    // the same as that of a stable sort on the column values.
+    Group g;
+    TableRef t = g.add_table("t");
+    auto int_col = t->add_column(type_Int, "int", true);
+    auto bool_col = t->add_column(type_Bool, "bool");
+    auto ts_col = t->add_column(type_Timestamp, "ts", true);
+    auto oid_col = t->add_column(type_ObjectId, "oid");
+    auto uuid_col = t->add_column(type_UUID, "uuid", true);
+    auto second_col = t->add_column(type_Int, "second");
+
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    for (size_t i = 0; i < 3000; ++i) {
+        Obj obj = t->create_object();
+        if (random.draw_int_mod(10) != 0)
+            obj.set(int_col, random.draw_int<int64_t>(-100, 100) * (int64_t(1) << random.draw_int_mod(50)));
+        obj.set(bool_col, random.draw_bool());
+        if (random.draw_int_mod(10) != 0) {
+            // Seconds and nanoseconds must not have different signs
+            int64_t seconds = random.draw_int<int64_t>(-3, 3);
+            int32_t nanoseconds = random.draw_int<int32_t>(0, 2);
+            if (seconds < 0)
+                nanoseconds = -nanoseconds;
+            else if (seconds == 0)
+                nanoseconds = random.draw_int<int32_t>(-2, 2);
+            obj.set(ts_col, Timestamp(seconds, nanoseconds));
+        }
+        obj.set(oid_col, ObjectId(Timestamp(random.draw_int<int64_t>(0, 10), 0), random.draw_int_mod(3),
+                                  random.draw_int_mod(3)));
+        if (random.draw_int_mod(10) != 0) {
+            UUID::UUIDBytes bytes{};
+            bytes[0] = uint8_t(random.draw_int_mod(3));
+            bytes[15] = uint8_t(random.draw_int_mod(256));
+            obj.set(uuid_col, UUID(bytes));
+        }
+        obj.set(second_col, random.draw_int_mod(5));
+    }
+
+    for (ColKey col : {int_col, bool_col, ts_col, oid_col, uuid_col}) {
+        for (bool ascending : {true, false}) {
+            for (bool with_second : {false, true}) {
+                std::vector<ObjKey> expected;
+                for (auto& obj : *t)
+                    expected.push_back(obj.get_key());
+                std::stable_sort(expected.begin(), expected.end(), [&](ObjKey a, ObjKey b) {
+                    int c = t->get_object(a).get_any(col).compare(t->get_object(b).get_any(col));
+                    if (c == 0 && with_second)
+                        c = t->get_object(a).get_any(second_col).compare(t->get_object(b).get_any(second_col));
+                    return ascending ? c < 0 : c > 0;
+                });
+
+                SortDescriptor sort = with_second ? SortDescriptor({{col}, {second_col}}, {ascending, ascending})
+                                                  : SortDescriptor({{col}}, {ascending});
+                TableView tv = t->where().find_all();
+                tv.sort(sort);
+                CHECK_EQUAL(tv.size(), expected.size());
+                for (size_t i = 0; i < tv.size(); ++i) {
+                    if (!CHECK_EQUAL(tv.get_key(i), expected[i]))
+                        break;
+                }
+            }
+        }
+    }
+}
+
 TEST(Query_SortDescending)
 {
     Random random(random_int<unsigned long>()); // Seed from slow global generator
@@ -4569,6 +4980,46 @@ TEST(Query_FindWithDescriptorOrdering)
 }
 
 
+TEST(Query_SortWithLimit)
+{
+    Group g;
+    TableRef t = g.add_table("t");
+    auto int_col = t->add_column(type_Int, "int");
+    auto str_col = t->add_column(type_String, "str", true);
+
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    const char* strings[] = {"A", "B", "C", nullptr};
+    for (size_t i = 0; i < 1000; ++i) {
+        t->create_object().set_all(random.draw_int_mod(20), StringData(strings[random.draw_int_mod(4)]));
+    }
+
+    for (size_t limit : {0, 1, 5, 50, 999, 1000, 2000}) {
+        for (bool ascending : {true, false}) {
+            // Selecting the top elements must give the same result as a full
+            // sort followed by the limit, including the order of ties.
+            SortDescriptor sort({{int_col}, {str_col}}, {ascending, !ascending});
+            DescriptorOrdering full_ordering;
+            full_ordering.append_sort(sort);
+            TableView full = t->where().find_all(full_ordering);
+
+            DescriptorOrdering ordering;
+            ordering.append_sort(sort);
+            ordering.append_limit(LimitDescriptor(limit));
+            TableView tv = t->where().find_all(ordering);
+            CHECK_EQUAL(tv.size(), std::min(limit, full.size()));
+            for (size_t i = 0; i < tv.size(); ++i) {
+                CHECK_EQUAL(tv.get_key(i), full.get_key(i));
+            }
+
+            // A following sort only sees the selected elements
+            ordering.append_sort(SortDescriptor({{str_col}}, {true}));
+            tv = t->where().find_all(ordering);
+            CHECK_EQUAL(tv.size(), std::min(limit, full.size()));
+        }
+    }
+}
+
+
 TEST(Query_FindWithDescriptorOrderingOverTableviewSync)
 {
     Group g;
@@ -4657,6 +5108,78 @@ TEST(Query_FindWithDescriptorOrderingOverTableviewSync)
     }
 }
 
+TEST(Query_DistinctMultipleColumnsAndLinks)
+{
+    Group g;
+    TableRef origin = g.add_table("origin");
+    TableRef target = g.add_table("target");
+    auto int_col = origin->add_column(type_Int, "int", true);
+    auto str_col = origin->add_column(type_String, "str", true);
+    auto link_col = origin->add_column(*target, "link");
+    auto double_col = origin->add_column(type_Double, "double");
+    auto target_str_col = target->add_column(type_String, "str");
+
+    std::vector<ObjKey> target_keys;
+    for (const char* str : {"X", "Y", "Z"})
+        target_keys.push_back(target->create_object().set(target_str_col, str).get_key());
+
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    const char* strings[] = {"A", "B", nullptr};
+    for (size_t i = 0; i < 500; ++i) {
+        Obj obj = origin->create_object();
+        if (random.draw_int_mod(5) != 0)
+            obj.set(int_col, random.draw_int_mod(4));
+        obj.set(str_col, StringData(strings[random.draw_int_mod(3)]));
+        size_t link = random.draw_int_mod(4);
+        if (link < 3)
+            obj.set(link_col, target_keys[link]);
+        obj.set(double_col, double(random.draw_int_mod(3)));
+    }
+
+    // Compute the expected result by keeping the first occurrence of each
+    // distinct combination of values, in the order of the sorted view.
+    auto check = [&](std::vector<std::vector<ColKey>> columns) {
+        TableView tv = origin->where().find_all();
+        tv.sort(SortDescriptor({{double_col}}, {false}));
+        std::vector<ObjKey> expected;
+        std::set<std::vector<Mixed>> seen;
+        for (size_t i = 0; i < tv.size(); ++i) {
+            std::vector<Mixed> values;
+            bool has_null_link = false;
+            for (auto& path : columns) {
+                Obj obj = tv.get(i);
+                for (size_t j = 0; j + 1 < path.size(); ++j) {
+                    if (obj.is_null(path[j])) {
+                        has_null_link = true;
+                        break;
+                    }
+                    obj = obj.get_linked_object(path[j]);
+                }
+                if (has_null_link)
+                    break;
+                values.push_back(obj.get_any(path.back()));
+            }
+            if (!has_null_link && seen.insert(values).second)
+                expected.push_back(tv.get_key(i));
+        }
+
+        tv.distinct(DistinctDescriptor(columns));
+        CHECK_EQUAL(tv.size(), expected.size());
+        for (size_t i = 0; i < tv.size() && i < expected.size(); ++i)
+            CHECK_EQUAL(tv.get_key(i), expected[i]);
+    };
+
+    check({{int_col}});
+    check({{str_col}});
+    check({{int_col}, {str_col}});
+    check({{link_col}});
+    check({{link_col, target_str_col}});
+    check({{str_col}, {link_col, target_str_col}, {int_col}});
+    check({{double_col}});
+    check({{double_col}, {int_col}});
+}
+
+
 TEST(Query_DistinctAndSort)
 {
     Group g;
@@ -5459,6 +5982,127 @@ TEST(Query_Sort_And_Requery_Untyped_Monkey2)
     }
 }
 
+TEST(Query_GroupBy)
+{
+    Group g;
+    TableRef customers = g.add_table("customers");
+    TableRef orders = g.add_table("orders");
+    auto name_col = customers->add_column(type_String, "name");
+    auto customer_col = orders->add_column(*customers, "customer");
+    auto region_col = orders->add_column(type_String, "region", true);
+    auto amount_col = orders->add_column(type_Int, "amount", true);
+    auto price_col = orders->add_column(type_Double, "price");
+    auto total_col = orders->add_column(type_Decimal, "total");
+    auto date_col = orders->add_column(type_Timestamp, "date");
+
+    std::vector<ObjKey> customer_keys;
+    for (const char* name : {"Alice", "Bob", "Carol"})
+        customer_keys.push_back(customers->create_object().set(name_col, name).get_key());
+
+    const char* regions[] = {"North", "South", nullptr};
+    for (int i = 0; i < 2000; ++i) {
+        Obj obj = orders->create_object();
+        if (i % 10 != 0)
+            obj.set(customer_col, customer_keys[i % 3]);
+        obj.set(region_col, StringData(regions[i % 3 == 0 ? 0 : (i % 5 == 0 ? 2 : 1)]));
+        if (i % 7 != 0)
+            obj.set(amount_col, i % 100);
+        obj.set(price_col, i * 0.5);
+        obj.set(total_col, Decimal128(i));
+        obj.set(date_col, Timestamp(i, 0));
+    }
+
+    // Compute the expected result with a plain loop over the objects
+    Query q = orders->where().greater_equal(price_col, 100.0);
+    TableView tv = q.find_all();
+    auto check = [&](ColKey group_col, GroupByOp op, ColKey agg_col) {
+        GroupByResult result = q.group_by(group_col, op, agg_col);
+        std::map<Mixed, std::vector<Mixed>> expected;
+        for (size_t i = 0; i < tv.size(); ++i) {
+            Obj obj = tv.get(i);
+            expected[obj.get_any(group_col)].push_back(op == GroupByOp::count ? Mixed() : obj.get_any(agg_col));
+        }
+        CHECK_EQUAL(result.size(), expected.size());
+        CHECK_EQUAL(result.counts.size(), result.size());
+        CHECK_EQUAL(result.values.size(), op == GroupByOp::count ? 0 : result.size());
+        for (size_t i = 0; i < result.size(); ++i) {
+            auto it = expected.find(result.keys[i]);
+            if (!CHECK(it != expected.end()))
+                continue;
+            CHECK_EQUAL(result.counts[i], it->second.size());
+            if (op == GroupByOp::count)
+                continue;
+            Mixed value;
+            size_t value_count = 0;
+            for (auto& v : it->second) {
+                if (v.is_null())
+                    continue;
+                ++value_count;
+                if (op == GroupByOp::min)
+                    value = (value_count == 1 || v < value) ? v : value;
+                else if (op == GroupByOp::max)
+                    value = (value_count == 1 || v > value) ? v : value;
+                else if (agg_col == amount_col)
+                    value = (value.is_null() ? 0 : value.get_int()) + v.get_int();
+                else if (agg_col == price_col)
+                    value = (value.is_null() ? 0 : value.get_double()) + v.get_double();
+            }
+            if (op == GroupByOp::sum && value.is_null())
+                value = agg_col == amount_col ? Mixed(0) : Mixed(0.0);
+            if (op == GroupByOp::average && value_count)
+                value = (agg_col == amount_col ? double(value.get_int()) : value.get_double()) / value_count;
+            CHECK_EQUAL(result.values[i], value);
+        }
+    };
+
+    check(region_col, GroupByOp::count, ColKey());
+    check(customer_col, GroupByOp::count, ColKey());
+    check(amount_col, GroupByOp::count, ColKey());
+    for (GroupByOp op : {GroupByOp::sum, GroupByOp::min, GroupByOp::max, GroupByOp::average}) {
+        check(region_col, op, amount_col);
+        check(customer_col, op, price_col);
+    }
+    check(region_col, GroupByOp::min, date_col);
+    check(customer_col, GroupByOp::max, date_col);
+
+    // Decimal sums
+    GroupByResult result = orders->where().group_by(region_col, GroupByOp::sum, total_col);
+    Decimal128 total_sum(0);
+    for (auto& value : result.values)
+        total_sum += value.get<Decimal128>();
+    CHECK_EQUAL(total_sum, orders->where().sum_decimal128(total_col));
+    size_t total_count = 0;
+    for (auto count : result.counts)
+        total_count += count;
+    CHECK_EQUAL(total_count, orders->size());
+
+    // String keys remain valid after the result is moved, and it cannot be copied
+    static_assert(!std::is_copy_constructible<GroupByResult>::value, "");
+    static_assert(!std::is_copy_assignable<GroupByResult>::value, "");
+    GroupByResult moved = std::move(result);
+    std::set<std::string> region_names;
+    for (auto& key : moved.keys) {
+        if (!key.is_null())
+            region_names.insert(std::string(key.get_string()));
+    }
+    CHECK_EQUAL(region_names.size(), 2);
+
+    CHECK_THROW(q.group_by(region_col, GroupByOp::sum, date_col), LogicError);
+    CHECK_THROW(q.group_by(region_col, GroupByOp::sum, region_col), LogicError);
+
+    // Only columns of single values can be grouped by
+    auto mixed_col = orders->add_column(type_Mixed, "mixed");
+    auto typed_link_col = orders->add_column(type_TypedLink, "typed_link");
+    auto list_col = orders->add_column_list(type_Int, "list");
+    auto link_list_col = orders->add_column_list(*customers, "customers");
+    CHECK_THROW(q.group_by(mixed_col), LogicError);
+    CHECK_THROW(q.group_by(typed_link_col), LogicError);
+    CHECK_THROW(q.group_by(list_col), LogicError);
+    CHECK_THROW(q.group_by(link_list_col), LogicError);
+    ColKey backlink_col = orders->get_opposite_column(customer_col);
+    CHECK_THROW(customers->where().group_by(backlink_col), LogicError);
+}
+
 TEST(Query_Performance)
 {
     Group g;
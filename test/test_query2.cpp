@@ -2574,6 +2574,106 @@ TEST(Query_Null_ManyRows)
     CHECK(equals(tv, non_nulls));
 }
 
+TEST(Query_ArithmeticExpressions)
+{
+    // Arithmetic expressions are evaluated in batches. Check the result
+    // against a direct evaluation, including null operands.
+    Random random(random_int<unsigned long>());
+    Table table;
+    auto col_int = table.add_column(type_Int, "int");
+    auto col_int_null = table.add_column(type_Int, "int_null", true);
+    auto col_double = table.add_column(type_Double, "double", true);
+    auto col_float = table.add_column(type_Float, "float");
+
+    for (size_t i = 0; i < 3000; i++) {
+        Obj obj = table.create_object();
+        obj.set(col_int, random.draw_int<int64_t>(-100, 100));
+        if (random.draw_int_mod(10) != 0)
+            obj.set(col_int_null, random.draw_int<int64_t>(-100, 100));
+        if (random.draw_int_mod(10) != 0)
+            obj.set(col_double, random.draw_int<int64_t>(-1000, 1000) / 8.0);
+        // Non-zero, so that the division below is well defined
+        obj.set(col_float, float(random.draw_int<int64_t>(1, 1000) / 4.0) * (random.draw_bool() ? 1 : -1));
+    }
+
+    using OptInt = util::Optional<int64_t>;
+    using OptDouble = util::Optional<double>;
+    auto check = [&](Query q, util::FunctionRef<bool(const Obj&)> predicate) {
+        size_t expected = 0;
+        for (auto& obj : table) {
+            if (predicate(obj))
+                ++expected;
+        }
+        CHECK_EQUAL(q.count(), expected);
+    };
+    auto get_int = [&](const Obj& obj) {
+        return obj.get<OptInt>(col_int_null);
+    };
+    auto get_double = [&](const Obj& obj) {
+        return obj.get<OptDouble>(col_double);
+    };
+
+    check(table.column<Int>(col_int) * table.column<Int>(col_int_null) > 1000, [&](const Obj& obj) {
+        auto v = get_int(obj);
+        return v && obj.get<Int>(col_int) * *v > 1000;
+    });
+    check(table.column<Int>(col_int) + 2 == table.column<Int>(col_int_null), [&](const Obj& obj) {
+        auto v = get_int(obj);
+        return v && obj.get<Int>(col_int) + 2 == *v;
+    });
+    check(table.column<Int>(col_int_null) - 5 != table.column<Int>(col_int), [&](const Obj& obj) {
+        auto v = get_int(obj);
+        return !v || *v - 5 != obj.get<Int>(col_int);
+    });
+    check(table.column<Int>(col_int_null) * 2 == null(), [&](const Obj& obj) {
+        return !get_int(obj);
+    });
+    check(table.column<Double>(col_double) * table.column<Int>(col_int) > 1000, [&](const Obj& obj) {
+        auto v = get_double(obj);
+        return v && *v * obj.get<Int>(col_int) > 1000;
+    });
+    check(table.column<Double>(col_double) / table.column<Float>(col_float) <= 0.5, [&](const Obj& obj) {
+        auto v = get_double(obj);
+        return v && *v / obj.get<Float>(col_float) <= 0.5;
+    });
+    check(table.column<Double>(col_double) + table.column<Int>(col_int_null) >= table.column<Float>(col_float),
+          [&](const Obj& obj) {
+              auto d = get_double(obj);
+              auto i = get_int(obj);
+              return d && i && *d + *i >= obj.get<Float>(col_float);
+          });
+    check(table.column<Double>(col_double) - 1.5 < table.column<Double>(col_double) * 2, [&](const Obj& obj) {
+        auto d = get_double(obj);
+        return d && *d - 1.5 < *d * 2;
+    });
+    check(table.column<Int>(col_int) * 3 <= table.column<Int>(col_int_null) - table.column<Int>(col_int),
+          [&](const Obj& obj) {
+              auto v = get_int(obj);
+              return v && obj.get<Int>(col_int) * 3 <= *v - obj.get<Int>(col_int);
+          });
+    check(table.column<Int>(col_int) / 3 > 10, [&](const Obj& obj) {
+        return obj.get<Int>(col_int) / 3 > 10;
+    });
+
+    // Combined with other conditions and restricted to a range
+    Query q = table.column<Int>(col_int) * 2 > 50;
+    q.and_query(table.where().less(col_float, 100.f));
+    size_t count = 0;
+    for (auto& obj : table) {
+        if (obj.get<Int>(col_int) * 2 > 50 && obj.get<Float>(col_float) < 100.f)
+            ++count;
+    }
+    CHECK_EQUAL(q.count(), count);
+    CHECK_EQUAL(q.find_all(0, size_t(-1), 10).size(), std::min(count, size_t(10)));
+    ObjKey first = q.find();
+    for (auto& obj : table) {
+        if (obj.get<Int>(col_int) * 2 > 50 && obj.get<Float>(col_float) < 100.f) {
+            CHECK_EQUAL(first, obj.get_key());
+            break;
+        }
+    }
+}
+
 TEST(Query_Null_Sort)
 {
     Group g;
@@ -3577,6 +3677,129 @@ TEST(Query_CompareThroughUnaryLinks)
     CHECK_EQUAL(k2, tv.get_key(0));
 }
 
+TEST(Query_SelectiveConditionsOverLinks)
+{
+    // Conditions over links matching few target objects are evaluated on the
+    // target table and mapped back through the backlinks. Check that the
+    // result is the same as when following the links from each object.
+    Group group;
+    TableRef target = group.add_table("target");
+    auto col_int = target->add_column(type_Int, "int", true);
+    auto col_str = target->add_column(type_String, "string", true);
+    auto col_date = target->add_column(type_Timestamp, "date");
+    TableRef middle = group.add_table("middle");
+    auto col_middle_link = middle->add_column(*target, "link");
+    auto col_middle_list = middle->add_column_list(*target, "list");
+    TableRef origin = group.add_table("origin");
+    auto col_link = origin->add_column(*target, "link");
+    auto col_list = origin->add_column_list(*target, "list");
+    auto col_chain = origin->add_column(*middle, "middle");
+
+    for (int i = 0; i < 200; i++) {
+        Obj obj = target->create_object().set(col_str, util::to_string(i)).set(col_date, Timestamp(i, 0));
+        if (i % 10 != 0)
+            obj.set(col_int, i);
+    }
+    for (int i = 0; i < 100; i++) {
+        Obj obj = middle->create_object();
+        obj.set(col_middle_link, target->get_object(i * 2).get_key());
+        obj.get_linklist(col_middle_list).add(target->get_object(199 - i).get_key());
+    }
+    for (int i = 0; i < 1000; i++) {
+        Obj obj = origin->create_object();
+        if (i % 7 != 0)
+            obj.set(col_link, target->get_object(i * 13 % 200).get_key());
+        auto list = obj.get_linklist(col_list);
+        for (int j = 0; j < i % 4; j++)
+            list.add(target->get_object((i + j * 31) % 200).get_key());
+        if (i % 5 != 0)
+            obj.set(col_chain, middle->get_object(i % 100).get_key());
+    }
+
+    auto check = [&](Query q, util::FunctionRef<bool(Obj)> predicate) {
+        TableView tv = q.find_all();
+        size_t expected = 0;
+        for (auto obj : *origin) {
+            if (predicate(obj)) {
+                CHECK_EQUAL(tv.find_by_source_ndx(obj.get_key()) != npos, true);
+                ++expected;
+            }
+        }
+        CHECK_EQUAL(tv.size(), expected);
+    };
+    auto linked = [](Obj obj, ColKey col) -> util::Optional<Obj> {
+        if (obj.is_null(col))
+            return util::none;
+        return obj.get_linked_object(col);
+    };
+    auto any_in_list = [](Obj obj, ColKey col, util::FunctionRef<bool(Obj)> predicate) {
+        auto list = obj.get_linklist(col);
+        for (size_t i = 0; i < list.size(); i++) {
+            if (predicate(list.get_object(i)))
+                return true;
+        }
+        return false;
+    };
+
+    for (int64_t v : {5, 50, 150, 190}) {
+        check(origin->link(col_link).column<Int>(col_int) == v, [&](Obj obj) {
+            auto t = linked(obj, col_link);
+            return t && t->get<util::Optional<int64_t>>(col_int) == v;
+        });
+        check(origin->link(col_link).column<Int>(col_int) > v, [&](Obj obj) {
+            auto t = linked(obj, col_link);
+            return t && t->get<util::Optional<int64_t>>(col_int) && *t->get<util::Optional<int64_t>>(col_int) > v;
+        });
+        check(origin->link(col_link).column<Int>(col_int) <= v, [&](Obj obj) {
+            auto t = linked(obj, col_link);
+            return t && t->get<util::Optional<int64_t>>(col_int) && *t->get<util::Optional<int64_t>>(col_int) <= v;
+        });
+        check(origin->link(col_link).column<Int>(col_int) != v, [&](Obj obj) {
+            auto t = linked(obj, col_link);
+            return !t || !(t->get<util::Optional<int64_t>>(col_int) == v);
+        });
+        check(origin->link(col_list).column<Timestamp>(col_date) >= Timestamp(v, 0), [&](Obj obj) {
+            return any_in_list(obj, col_list, [&](Obj t) {
+                return t.get<Timestamp>(col_date) >= Timestamp(v, 0);
+            });
+        });
+        check(origin->link(col_chain).link(col_middle_list).column<Timestamp>(col_date) < Timestamp(v, 0),
+              [&](Obj obj) {
+                  auto m = linked(obj, col_chain);
+                  return m && any_in_list(*m, col_middle_list, [&](Obj t) {
+                             return t.get<Timestamp>(col_date) < Timestamp(v, 0);
+                         });
+              });
+        check(origin->link(col_chain).link(col_middle_link).column<Timestamp>(col_date) == Timestamp(v, 0),
+              [&](Obj obj) {
+                  auto m = linked(obj, col_chain);
+                  auto t = m ? linked(*m, col_middle_link) : util::none;
+                  return t && t->get<Timestamp>(col_date) == Timestamp(v, 0);
+              });
+        std::string str = util::to_string(v);
+        check(origin->link(col_list).column<String>(col_str).begins_with(str), [&](Obj obj) {
+            return any_in_list(obj, col_list, [&](Obj t) {
+                return t.get<String>(col_str).begins_with(str);
+            });
+        });
+    }
+
+    // A condition matching null must also find the objects with a null link
+    check(origin->link(col_link).column<Int>(col_int) == null(), [&](Obj obj) {
+        auto t = linked(obj, col_link);
+        return !t || !t->get<util::Optional<int64_t>>(col_int);
+    });
+
+    // The result must reflect changes to the target table
+    Query q = origin->link(col_link).column<Int>(col_int) == 13;
+    size_t count = q.count();
+    CHECK_GREATER(count, 0);
+    target->get_object(13).set(col_int, 14);
+    CHECK_EQUAL(q.count(), 0);
+    target->get_object(13).set(col_int, 13);
+    CHECK_EQUAL(q.count(), count);
+}
+
 TEST(Query_DeepLink)
 {
 
@@ -103,4 +103,29 @@ TEST(ServerHistory_Verify)
     }
 }
 
+
+TEST(ServerHistory_CompactionTierBegin)
+{
+    CHECK_EQUAL(0, get_history_compaction_tier_begin(0, 1));
+    CHECK_EQUAL(0, get_history_compaction_tier_begin(0, 5));
+    CHECK_EQUAL(4, get_history_compaction_tier_begin(5, 6));
+    CHECK_EQUAL(6, get_history_compaction_tier_begin(6, 7));
+    CHECK_EQUAL(0, get_history_compaction_tier_begin(7, 8));
+    CHECK_EQUAL(8, get_history_compaction_tier_begin(9, 10));
+    CHECK_EQUAL(0, get_history_compaction_tier_begin(1000, 1024));
+    CHECK_EQUAL(1024, get_history_compaction_tier_begin(1024, 1025));
+
+    // Every run must cover the newly compactable versions, and the amortized
+    // amount of work must be logarithmic in the number of runs
+    std::uint_fast64_t compacted_until = 0;
+    std::uint_fast64_t total_work = 0;
+    for (std::uint_fast64_t compact_until = 1; compact_until <= 1024; ++compact_until) {
+        std::uint_fast64_t begin = get_history_compaction_tier_begin(compacted_until, compact_until);
+        CHECK_LESS_EQUAL(begin, compacted_until);
+        total_work += compact_until - begin;
+        compacted_until = compact_until;
+    }
+    CHECK_LESS_EQUAL(total_work, 1024 * 11);
+}
+
 } // unnamed namespace
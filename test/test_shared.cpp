@@ -659,6 +659,148 @@ TEST(Shared_Initial)
 }
 
 
+TEST(Shared_AccessPatternOptions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.access_pattern = DBOptions::AccessPattern::Random;
+    options.populate_mappings = true;
+    {
+        DBRef db = DB::create(path, false, options);
+        WriteTransaction wt(db);
+        auto table = wt.add_table("table");
+        auto col = table->add_column(type_Int, "value");
+        for (int64_t i = 0; i < 10000; ++i)
+            table->create_object().set(col, i);
+        wt.commit();
+    }
+
+    for (auto pattern : {DBOptions::AccessPattern::Sequential, DBOptions::AccessPattern::Normal}) {
+        options.access_pattern = pattern;
+        DBRef db = DB::create(path, false, options);
+        // Compacting writes the entire Realm with a sequential access hint
+        CHECK(db->compact());
+        ReadTransaction rt(db);
+        auto table = rt.get_table("table");
+        auto col = table->get_column_key("value");
+        CHECK_EQUAL(table->size(), 10000);
+        CHECK_EQUAL(table->sum_int(col), 10000 * 9999 / 2);
+    }
+}
+
+
+TEST(Shared_SharedReadLock)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    DBRef db = DB::create(*hist, DBOptions(crypt_key()));
+    ColKey col;
+    {
+        WriteTransaction wt(db);
+        col = wt.add_table("table")->add_column(type_Int, "value");
+        wt.commit();
+    }
+
+    // Transactions in the same DB bound to the same version share the lock on it
+    auto rt1 = db->start_read();
+    auto rt2 = db->start_read();
+    auto version = rt1->get_version_of_current_transaction();
+    CHECK(rt2->get_version_of_current_transaction() == version);
+    auto rt3 = db->start_read(version);
+    CHECK(rt3->get_version_of_current_transaction() == version);
+
+    for (int i = 0; i < 3; ++i) {
+        WriteTransaction wt(db);
+        wt.get_table("table")->create_object().set(col, i);
+        wt.commit();
+    }
+    rt1->advance_read();
+    CHECK_EQUAL(rt1->get_table("table")->size(), 3);
+
+    // The version stays available as long as any of them is bound to it
+    rt2.reset();
+    {
+        auto rt = db->start_read(version);
+        CHECK_EQUAL(rt->get_table("table")->size(), 0);
+    }
+    CHECK_EQUAL(rt3->get_table("table")->size(), 0);
+    rt3.reset();
+
+    for (int i = 0; i < 3; ++i) {
+        WriteTransaction wt(db);
+        wt.get_table("table")->create_object().set(col, i);
+        wt.commit();
+    }
+    CHECK_THROW(db->start_read(version), DB::BadVersion);
+    CHECK_EQUAL(rt1->get_table("table")->size(), 3);
+    rt1->end_read();
+    CHECK_EQUAL(db->start_read()->get_table("table")->size(), 6);
+}
+
+
+TEST(Shared_LargeCommit)
+{
+    // Large commits are written to the file in long runs. Check that the
+    // data reaches the file intact, and that a reader of the previous
+    // version is not disturbed by it.
+    SHARED_GROUP_TEST_PATH(path);
+    const int64_t num_objects = 50000;
+    {
+        DBOptions options(crypt_key());
+        options.enable_metrics = true;
+        DBRef db = DB::create(path, false, options);
+        {
+            WriteTransaction wt(db);
+            auto table = wt.add_table("table");
+            auto col_int = table->add_column(type_Int, "int");
+            auto col_str = table->add_column(type_String, "str");
+            for (int64_t i = 0; i < num_objects; ++i)
+                table->create_object(ObjKey(i)).set(col_int, i).set(col_str, util::to_string(i));
+            wt.commit();
+        }
+        ReadTransaction rt(db);
+        {
+            WriteTransaction wt(db);
+            auto table = wt.get_table("table");
+            auto col_int = table->get_column_key("int");
+            auto col_str = table->get_column_key("str");
+            for (int64_t i = 0; i < num_objects; i += 3)
+                table->get_object(ObjKey(i)).set(col_int, -i).set(col_str, util::to_string(-i));
+            wt.commit();
+        }
+        auto table = rt.get_table("table");
+        auto col_int = table->get_column_key("int");
+        for (int64_t i = 0; i < num_objects; i += 3)
+            CHECK_EQUAL(table->get_object(ObjKey(i)).get<Int>(col_int), i);
+        rt.get_group().verify();
+#if REALM_METRICS
+        // The update was large enough to have its arrays written in long runs
+        auto transactions = db->get_metrics()->take_transactions();
+        std::vector<size_t> extent_sizes;
+        for (auto& t : *transactions) {
+            if (t.get_transaction_type() == metrics::TransactionInfo::write_transaction)
+                extent_sizes.push_back(t.get_extent_size());
+        }
+        if (CHECK_EQUAL(extent_sizes.size(), 2))
+            CHECK_GREATER(extent_sizes[1], 0);
+#endif // REALM_METRICS
+    }
+    DBRef db = DB::create(path, false, DBOptions(crypt_key()));
+    ReadTransaction rt(db);
+    rt.get_group().verify();
+    auto table = rt.get_table("table");
+    auto col_int = table->get_column_key("int");
+    auto col_str = table->get_column_key("str");
+    CHECK_EQUAL(table->size(), num_objects);
+    for (int64_t i = 0; i < num_objects; ++i) {
+        int64_t expected = i % 3 ? i : -i;
+        Obj obj = table->get_object(ObjKey(i));
+        CHECK_EQUAL(obj.get<Int>(col_int), expected);
+        CHECK_EQUAL(obj.get<String>(col_str), util::to_string(expected));
+    }
+}
+
+
 TEST(Shared_InitialMem)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -1557,6 +1699,314 @@ TEST(Shared_WriterThreads)
 }
 
 
+TEST(Shared_WriteTimeout)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path, false, DBOptions(crypt_key()));
+
+    auto wt = sg->start_write();
+    Thread thread;
+    thread.start([&] {
+        auto start = std::chrono::steady_clock::now();
+        CHECK_NOT(sg->start_write(DB::WritePriority::Normal, std::chrono::milliseconds(50)));
+        CHECK_NOT(sg->start_write(DB::WritePriority::High, std::chrono::milliseconds(50)));
+        CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(100));
+    });
+    thread.join();
+    wt->commit();
+
+    thread.start([&] {
+        auto tr = sg->start_write(DB::WritePriority::Normal, std::chrono::milliseconds(5000));
+        CHECK(tr);
+        tr->commit();
+    });
+    thread.join();
+}
+
+
+TEST(Shared_WritePriority)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path, false, DBOptions(crypt_key()));
+    ColKey col;
+    {
+        WriteTransaction wt(sg);
+        col = wt.add_table("log")->add_column(type_Int, "priority");
+        wt.commit();
+    }
+
+    auto writer = [&](DB::WritePriority priority) {
+        auto tr = sg->start_write(priority);
+        tr->get_table("log")->create_object().set(col, int64_t(priority));
+        tr->commit();
+    };
+
+    // While the write lock is held, a writer of normal priority queues up
+    // before one of high priority. The latter must still be let in first.
+    auto wt = sg->start_write();
+    Thread normal, high;
+    normal.start([&] {
+        writer(DB::WritePriority::Normal);
+    });
+    millisleep(100);
+    high.start([&] {
+        writer(DB::WritePriority::High);
+    });
+    millisleep(100);
+    wt->commit();
+    normal.join();
+    high.join();
+
+    ReadTransaction rt(sg);
+    auto table = rt.get_table("log");
+    CHECK_EQUAL(table->size(), 2);
+    CHECK_EQUAL(table->begin()->get<Int>(col), int64_t(DB::WritePriority::High));
+}
+
+
+TEST(Shared_WritePriorityAfterFairnessLimit)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path, false, DBOptions(crypt_key()));
+    ColKey col;
+    {
+        WriteTransaction wt(sg);
+        col = wt.add_table("log")->add_column(type_String, "writer");
+        wt.commit();
+    }
+
+    auto writer = [&](const char* name, DB::WritePriority priority, bool with_timeout, int hold_ms) {
+        auto tr = with_timeout ? sg->start_write(priority, std::chrono::milliseconds(10000))
+                               : sg->start_write(priority);
+        CHECK(tr);
+        tr->get_table("log")->create_object().set(col, name);
+        millisleep(hold_ms);
+        tr->commit();
+    };
+
+    // A writer of normal priority yields to the writers of high priority for
+    // a limited time only. Once it stops yielding, the writers of high
+    // priority which are still waiting must keep their priority over those of
+    // normal priority queued behind it.
+    auto wt = sg->start_write();
+    Thread normal_1, high_1, high_2, normal_2;
+    normal_1.start([&] {
+        writer("normal 1", DB::WritePriority::Normal, false, 0);
+    });
+    millisleep(50);
+    high_1.start([&] {
+        writer("high 1", DB::WritePriority::High, true, 700);
+    });
+    millisleep(50);
+    wt->commit();
+    millisleep(100);
+    high_2.start([&] {
+        writer("high 2", DB::WritePriority::High, true, 0);
+    });
+    normal_2.start([&] {
+        writer("normal 2", DB::WritePriority::Normal, false, 0);
+    });
+    normal_1.join();
+    high_1.join();
+    high_2.join();
+    normal_2.join();
+
+    ReadTransaction rt(sg);
+    std::vector<std::string> order;
+    for (auto& obj : *rt.get_table("log"))
+        order.push_back(obj.get<String>(col));
+    CHECK_EQUAL(order.size(), 4);
+    auto position = [&](const char* name) {
+        return std::find(order.begin(), order.end(), name) - order.begin();
+    };
+    CHECK_LESS(position("high 1"), position("normal 1"));
+    CHECK_LESS(position("high 2"), position("normal 2"));
+}
+
+
+TEST(Shared_WriteOptimistic)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    DBRef sg = DB::create(*hist, DBOptions(crypt_key()));
+    ColKey col_a, col_b, col_link;
+    ObjKey key_a, key_b;
+    {
+        WriteTransaction wt(sg);
+        auto a = wt.add_table("a");
+        auto b = wt.add_table("b");
+        col_a = a->add_column(type_Int, "value");
+        col_b = b->add_column(type_Int, "value");
+        col_link = a->add_column(*b, "link");
+        key_b = b->create_object().get_key();
+        key_a = a->create_object().set(col_link, key_b).get_key();
+        wt.commit();
+    }
+    auto commit_elsewhere = [&](Transaction& tr, const char* table_name, ColKey col, ObjKey key) {
+        // Only while outside the write lock, as another write would block
+        if (tr.get_transact_stage() != DB::transact_Reading)
+            return;
+        auto wt = sg->start_write();
+        wt->get_table(table_name)->get_object(key).add_int(col, 1);
+        wt->commit();
+    };
+
+    // A commit to a table not read does not make prepare run again
+    int num_prepared = 0;
+    int64_t value = 0;
+    sg->write_optimistic(
+        [&](Transaction& tr) {
+            ++num_prepared;
+            value = tr.get_table("a")->get_object(key_a).get<Int>(col_a);
+            commit_elsewhere(tr, "b", col_b, key_b);
+        },
+        [&](Transaction& tr) {
+            tr.get_table("a")->get_object(key_a).set(col_a, value + 10);
+        });
+    CHECK_EQUAL(num_prepared, 1);
+
+    // A commit to a table read does
+    num_prepared = 0;
+    sg->write_optimistic(
+        [&](Transaction& tr) {
+            value = tr.get_table("a")->get_object(key_a).get<Int>(col_a);
+            if (num_prepared++ == 0)
+                commit_elsewhere(tr, "a", col_a, key_a);
+        },
+        [&](Transaction& tr) {
+            tr.get_table("a")->get_object(key_a).set(col_a, value + 10);
+        });
+    CHECK_EQUAL(num_prepared, 2);
+
+    // So does a change of links to a table read
+    num_prepared = 0;
+    sg->write_optimistic(
+        [&](Transaction& tr) {
+            value = tr.get_table("b")->get_object(key_b).get_backlink_count();
+            if (num_prepared++ == 0) {
+                auto wt = sg->start_write();
+                wt->get_table("a")->create_object().set(col_link, key_b);
+                wt->commit();
+            }
+        },
+        [&](Transaction& tr) {
+            tr.get_table("b")->get_object(key_b).set(col_b, value);
+        });
+    CHECK_EQUAL(num_prepared, 2);
+
+    // Conflicting every time, prepare is finally run under the write lock
+    num_prepared = 0;
+    sg->write_optimistic(
+        [&](Transaction& tr) {
+            ++num_prepared;
+            value = tr.get_table("a")->get_object(key_a).get<Int>(col_a);
+            commit_elsewhere(tr, "a", col_a, key_a);
+        },
+        [&](Transaction& tr) {
+            tr.get_table("a")->get_object(key_a).set(col_a, value + 10);
+        },
+        2);
+    CHECK_EQUAL(num_prepared, 3);
+
+    ReadTransaction rt(sg);
+    CHECK_EQUAL(rt.get_table("a")->get_object(key_a).get<Int>(col_a), 10 + 1 + 10 + 2 + 10);
+    CHECK_EQUAL(rt.get_table("b")->get_object(key_b).get<Int>(col_b), 2);
+}
+
+
+TEST(Shared_WriteOptimisticThreads)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    DBRef sg = DB::create(*hist, DBOptions(crypt_key()));
+    const int thread_count = 4;
+    const int num_rounds = 50;
+    {
+        WriteTransaction wt(sg);
+        for (int i = 0; i < thread_count / 2; ++i) {
+            auto table = wt.add_table(util::format("counter_%1", i));
+            table->add_column(type_Int, "value");
+            table->create_object(ObjKey(0));
+        }
+        wt.commit();
+    }
+
+    // Pairs of threads increment the same counter, so no increment may be lost
+    Thread threads[thread_count];
+    for (int i = 0; i < thread_count; ++i) {
+        threads[i].start([&, i] {
+            std::string name = util::format("counter_%1", i / 2);
+            for (int round = 0; round < num_rounds; ++round) {
+                int64_t value = 0;
+                sg->write_optimistic(
+                    [&](Transaction& tr) {
+                        value = tr.get_table(name)->get_object(ObjKey(0)).get<Int>("value");
+                    },
+                    [&](Transaction& tr) {
+                        tr.get_table(name)->get_object(ObjKey(0)).set("value", value + 1);
+                    });
+            }
+        });
+    }
+    for (int i = 0; i < thread_count; ++i)
+        threads[i].join();
+
+    ReadTransaction rt(sg);
+    for (int i = 0; i < thread_count / 2; ++i) {
+        auto table = rt.get_table(util::format("counter_%1", i));
+        CHECK_EQUAL(table->get_object(ObjKey(0)).get<Int>("value"), 2 * num_rounds);
+    }
+}
+
+
+TEST(Shared_WriteQueueStress)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef sg = DB::create(path, false, DBOptions(crypt_key()));
+    ColKey col;
+    ObjKey key;
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("counter");
+        col = table->add_column(type_Int, "value");
+        key = table->create_object().get_key();
+        wt.commit();
+    }
+
+    // Writers of mixed priority, some of which give up while queued. Every
+    // writer which gets in must be counted exactly once, and giving up must not
+    // stall the writers behind.
+    const int thread_count = 8;
+    const int num_rounds = 50;
+    std::atomic<int64_t> num_commits(0);
+    Thread threads[thread_count];
+    for (int i = 0; i < thread_count; ++i) {
+        threads[i].start([&, i] {
+            for (int round = 0; round < num_rounds; ++round) {
+                auto priority = (i + round) % 4 == 0 ? DB::WritePriority::High : DB::WritePriority::Normal;
+                util::Optional<std::chrono::milliseconds> timeout;
+                if (i % 2)
+                    timeout = std::chrono::milliseconds(round % 3);
+                auto tr = sg->start_write(priority, timeout);
+                if (!tr) {
+                    CHECK(timeout);
+                    continue;
+                }
+                tr->get_table("counter")->get_object(key).add_int(col, 1);
+                tr->commit();
+                ++num_commits;
+            }
+        });
+    }
+    for (int i = 0; i < thread_count; ++i)
+        threads[i].join();
+
+    ReadTransaction rt(sg);
+    CHECK_EQUAL(rt.get_table("counter")->get_object(key).get<Int>(col), num_commits.load());
+    CHECK_GREATER_EQUAL(num_commits.load(), thread_count / 2 * num_rounds);
+}
+
+
 #if !REALM_ENABLE_ENCRYPTION && defined(ENABLE_ROBUST_AGAINST_DEATH_DURING_WRITE)
 // this unittest has issues that has not been fully understood, but could be
 // related to interaction between posix robust mutexes and the fork() system call.
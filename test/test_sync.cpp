@@ -7529,6 +7529,218 @@ TEST(Sync_ClientFileBlacklisting)
     CHECK_EQUAL(1.0, metrics.sum_equal("blacklisted"));
 }
 
+
+TEST(Sync_ServerMaxOpenFilesSize)
+{
+    TEST_DIR(dir);
+    SHARED_GROUP_TEST_PATH(path_1);
+    SHARED_GROUP_TEST_PATH(path_2);
+    SHARED_GROUP_TEST_PATH(path_3);
+    SHARED_GROUP_TEST_PATH(path_4);
+
+    // A budget this small forces the server to keep only the most recently
+    // accessed file open
+    MockMetrics metrics;
+    ClientServerFixture::Config config;
+    config.server_metrics = &metrics;
+    config.server_max_open_files_size = 1;
+    ClientServerFixture fixture(dir, test_context, config);
+    fixture.start();
+
+    const char* server_paths[2] = {"/test_1", "/test_2"};
+    std::string upload_paths[2] = {path_1, path_2};
+    std::string download_paths[2] = {path_3, path_4};
+    for (int i = 0; i < 2; ++i) {
+        std::unique_ptr<Replication> history = make_client_replication(upload_paths[i]);
+        DBRef sg = DB::create(*history);
+        WriteTransaction wt{sg};
+        TableRef table = sync::create_table(wt, "class_foo");
+        table->add_column(type_Int, "i");
+        table->create_object().set("i", i);
+        wt.commit();
+    }
+    for (int i = 0; i < 2; ++i) {
+        Session session = fixture.make_bound_session(upload_paths[i], server_paths[i]);
+        session.wait_for_upload_complete_or_client_stopped();
+    }
+    for (int i = 0; i < 2; ++i) {
+        Session session = fixture.make_bound_session(download_paths[i], server_paths[i]);
+        session.wait_for_download_complete_or_client_stopped();
+    }
+    for (int i = 0; i < 2; ++i) {
+        std::unique_ptr<Replication> history = make_client_replication(download_paths[i]);
+        DBRef sg = DB::create(*history);
+        ReadTransaction rt{sg};
+        ConstTableRef table = rt.get_table("class_foo");
+        if (CHECK(table) && CHECK_EQUAL(1, table->size()))
+            CHECK_EQUAL(i, table->begin()->get<Int>("i"));
+    }
+    // Files must have been reopened after having been closed due to the budget
+    CHECK_GREATER(metrics.count_equal("realms.open_time"), 4);
+}
+
+
+TEST(Sync_UploadCoalescing)
+{
+    TEST_DIR(dir);
+    SHARED_GROUP_TEST_PATH(path_1);
+    SHARED_GROUP_TEST_PATH(path_2);
+
+    std::unique_ptr<Replication> history_1 = make_client_replication(path_1);
+    std::unique_ptr<Replication> history_2 = make_client_replication(path_2);
+    DBRef sg_1 = DB::create(*history_1);
+    DBRef sg_2 = DB::create(*history_2);
+
+    // Many small transactions that will be uploaded in one go
+    {
+        WriteTransaction wt{sg_1};
+        TableRef table = sync::create_table_with_primary_key(wt, "class_foo", type_String, "_id");
+        table->add_column(type_Int, "i");
+        table->add_column(type_String, "s");
+        wt.commit();
+    }
+    for (int i = 0; i < 100; ++i) {
+        WriteTransaction wt{sg_1};
+        TableRef table = wt.get_table("class_foo");
+        std::string key = "key_" + std::to_string(i % 10);
+        Obj obj = table->create_object_with_primary_key(StringData(key));
+        obj.set("i", i);
+        obj.set("s", "value_" + std::to_string(i));
+        wt.commit();
+    }
+
+    ClientServerFixture::Config config;
+    config.client_upload_coalescing_max_size = 0x1000;
+    ClientServerFixture fixture(dir, test_context, config);
+    fixture.start();
+
+    Session session_1 = fixture.make_bound_session(path_1, "/test");
+    session_1.wait_for_upload_complete_or_client_stopped();
+    Session session_2 = fixture.make_bound_session(path_2, "/test");
+    session_2.wait_for_download_complete_or_client_stopped();
+
+    ReadTransaction rt_1(sg_1);
+    ReadTransaction rt_2(sg_2);
+    CHECK(compare_groups(rt_1, rt_2));
+    ConstTableRef table = rt_2.get_table("class_foo");
+    CHECK_EQUAL(10, table->size());
+    Obj obj = table->get_object_with_primary_key(Mixed{"key_9"});
+    CHECK_EQUAL(99, obj.get<Int>("i"));
+    CHECK_EQUAL("value_99", obj.get<String>("s"));
+
+    // Every changeset integrated by the server produces a new server version,
+    // so the server version counts the uploaded changesets. Without
+    // coalescing there would be one for each of the 101 transactions.
+    std::string server_path = fixture.map_virtual_to_real_path("/test");
+    TestServerHistoryContext context;
+    _impl::ServerHistory::DummyCompactionControl compaction_control;
+    _impl::ServerHistory server_history{server_path, context, compaction_control};
+    DBRef server_sg = DB::create(server_history);
+    VersionInfo version_info;
+    bool has_upstream_status;
+    file_ident_type partial_file_ident;
+    version_type partial_progress_reference_version;
+    server_history.get_status(version_info, has_upstream_status, partial_file_ident,
+                              partial_progress_reference_version);
+    CHECK_GREATER(version_info.sync_version.version, 0);
+    CHECK_LESS(version_info.sync_version.version, 101);
+}
+
+
+TEST(Sync_DownloadBootstrapCacheWithTail)
+{
+    TEST_DIR(dir);
+    SHARED_GROUP_TEST_PATH(path_1);
+    SHARED_GROUP_TEST_PATH(path_2);
+    SHARED_GROUP_TEST_PATH(path_3);
+
+    MockMetrics metrics;
+    ClientServerFixture::Config config;
+    config.server_metrics = &metrics;
+    config.server_enable_download_bootstrap_cache = true;
+    ClientServerFixture fixture(dir, test_context, config);
+    fixture.start();
+
+    std::unique_ptr<Replication> history_1 = make_client_replication(path_1);
+    std::unique_ptr<Replication> history_2 = make_client_replication(path_2);
+    std::unique_ptr<Replication> history_3 = make_client_replication(path_3);
+    DBRef sg_1 = DB::create(*history_1);
+    DBRef sg_2 = DB::create(*history_2);
+    DBRef sg_3 = DB::create(*history_3);
+
+    Session session_1 = fixture.make_bound_session(path_1, "/test");
+    auto add_object = [&](int value) {
+        WriteTransaction wt{sg_1};
+        TableRef table = wt.get_table("class_foo");
+        if (!table) {
+            table = sync::create_table(wt, "class_foo");
+            table->add_column(type_Int, "i");
+        }
+        table->create_object().set("i", value);
+        version_type new_version = wt.commit();
+        session_1.nonsync_transact_notify(new_version);
+    };
+    add_object(1);
+    session_1.wait_for_upload_complete_or_client_stopped();
+
+    // Bootstrapping the second client leaves a cached DOWNLOAD body behind.
+    // The body may already have been built when the first client
+    // bootstrapped, but in-place compaction of the history can have made it
+    // stale since, so it is either reused or built again.
+    std::size_t num_builds = metrics.count_equal("download.bootstrap_cache.build");
+    double num_hits = metrics.sum_equal("download.bootstrap_cache.hit");
+    Session session_2 = fixture.make_bound_session(path_2, "/test");
+    session_2.wait_for_download_complete_or_client_stopped();
+    CHECK_EQUAL(num_builds + 1, metrics.count_equal("download.bootstrap_cache.build") +
+                                    (metrics.sum_equal("download.bootstrap_cache.hit") - num_hits));
+
+    // Produce a tail of changesets that are not part of the cached body
+    add_object(2);
+    add_object(3);
+    session_1.wait_for_upload_complete_or_client_stopped();
+
+    // The third client must get the cached body followed by the tail
+    num_builds = metrics.count_equal("download.bootstrap_cache.build");
+    num_hits = metrics.sum_equal("download.bootstrap_cache.hit");
+    struct Progress {
+        std::uint_fast64_t downloaded_bytes;
+        std::uint_fast64_t total_bytes;
+    };
+    std::mutex progress_mutex;
+    std::vector<Progress> progress;
+    Session session_3 = fixture.make_session(path_3);
+    session_3.set_progress_handler([&](std::uint_fast64_t downloaded_bytes, std::uint_fast64_t total_bytes,
+                                       std::uint_fast64_t, std::uint_fast64_t, std::uint_fast64_t,
+                                       std::uint_fast64_t) {
+        std::lock_guard<std::mutex> lock{progress_mutex};
+        progress.push_back({downloaded_bytes, total_bytes});
+    });
+    fixture.bind_session(session_3, "/test");
+    session_3.wait_for_download_complete_or_client_stopped();
+    CHECK_EQUAL(num_hits + 1, metrics.sum_equal("download.bootstrap_cache.hit"));
+    CHECK_EQUAL(num_builds, metrics.count_equal("download.bootstrap_cache.build"));
+
+    // The tail was downloaded after the cached body, and was already counted
+    // in the total when the cached body had been downloaded
+    {
+        std::lock_guard<std::mutex> lock{progress_mutex};
+        auto after_body = std::find_if(progress.begin(), progress.end(), [](const Progress& p) {
+            return p.downloaded_bytes > 0;
+        });
+        if (CHECK(after_body != progress.end())) {
+            std::uint_fast64_t total = progress.back().downloaded_bytes;
+            CHECK_EQUAL(progress.back().total_bytes, total);
+            CHECK_LESS(after_body->downloaded_bytes, total);
+            CHECK_EQUAL(after_body->total_bytes, total);
+        }
+    }
+
+    ReadTransaction rt_1(sg_1);
+    ReadTransaction rt_3(sg_3);
+    CHECK_EQUAL(3, rt_3.get_table("class_foo")->size());
+    CHECK(compare_groups(rt_1, rt_3));
+}
+
 // This test could trigger the assertion that the row_for_object_id cache is
 // valid before the cache was properly invalidated in the case of a short
 // circuited sync replicator.
@@ -476,3 +476,47 @@ TEST(WebSocket_Interleaved_Fragmented_Messages)
     CHECK_EQUAL(config_2.binary_messages.size(), 1);
     CHECK_EQUAL(config_2.binary_messages[0], "abcd");
 }
+
+TEST(WebSocket_Large_Fragmented_Messages)
+{
+    Fixture fixt{test_context.logger};
+    WSConfig& config_1 = fixt.config_1;
+    WSConfig& config_2 = fixt.config_2;
+
+    websocket::Socket& socket_1 = fixt.socket_1;
+    websocket::Socket& socket_2 = fixt.socket_2;
+
+    socket_1.initiate_client_handshake("/uri", "host", "protocol");
+    socket_2.initiate_server_handshake();
+
+    CHECK_EQUAL(config_1.n_handshake_completed, 1);
+    CHECK_EQUAL(config_2.n_handshake_completed, 1);
+
+    int n_handler_calls = 0;
+    auto handler = [&]() {
+        ++n_handler_calls;
+    };
+
+    // Fragments of increasing size, such that the message buffer of the
+    // receiver must be expanded while a message is partially received.
+    std::vector<size_t> fragment_sizes{10, 3000, 16383, 16384, 100000, 1000000};
+    std::string expected;
+    for (size_t i = 0; i < fragment_sizes.size(); ++i) {
+        std::string fragment(fragment_sizes[i], char('a' + i));
+        expected += fragment;
+        bool fin = (i == fragment_sizes.size() - 1);
+        websocket::Opcode opcode = (i == 0 ? websocket::Opcode::binary : websocket::Opcode::continuation);
+        socket_1.async_write_frame(fin, opcode, fragment.data(), fragment.size(), handler);
+        socket_2.async_write_frame(fin, opcode, fragment.data(), fragment.size(), handler);
+    }
+    CHECK_EQUAL(n_handler_calls, 2 * int(fragment_sizes.size()));
+    CHECK_EQUAL(config_2.binary_messages.size(), 1);
+    CHECK_EQUAL(config_1.binary_messages.size(), 1);
+    CHECK(config_2.binary_messages[0] == expected);
+    CHECK(config_1.binary_messages[0] == expected);
+
+    // A small message after a large one is delivered correctly.
+    socket_2.async_write_binary("small", 5, handler);
+    CHECK_EQUAL(config_1.binary_messages.size(), 2);
+    CHECK_EQUAL(config_1.binary_messages[1], "small");
+}